@@ -0,0 +1,17 @@
+#include <assert.h>
+#include <string.h>
+
+char src[4096], dst[4096];
+
+int main()
+{
+  src[4095] = 'x';
+  memcpy(dst, src, sizeof(src));
+  assert(dst[4095] == 'x');
+
+  dst[0] = 'y';
+  memmove(dst + 1, dst, 8);
+  assert(dst[1] == 'y');
+  assert(strlen(dst) == 2);
+  return 0;
+}
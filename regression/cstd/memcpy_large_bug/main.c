@@ -0,0 +1,13 @@
+#include <string.h>
+
+unsigned int nondet_uint();
+
+char src[4096], dst[64];
+
+int main()
+{
+  unsigned int n = nondet_uint();
+  __ESBMC_assume(n <= sizeof(src));
+  memcpy(dst, src, n);
+  return 0;
+}
@@ -0,0 +1,23 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#define N 40
+
+int nondet_int();
+
+int *pool[N];
+
+int main()
+{
+  for(int i = 0; i < N; i++)
+  {
+    pool[i] = (int *)malloc(sizeof(int));
+    *pool[i] = i;
+  }
+
+  int k = nondet_int();
+  __ESBMC_assume(k >= 0 && k < N);
+  int *p = pool[k];
+  assert(*p != 23);
+  return 0;
+}
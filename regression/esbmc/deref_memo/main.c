@@ -0,0 +1,26 @@
+#include <assert.h>
+
+struct s
+{
+  int a, b;
+};
+
+struct s g;
+int *q;
+
+void f(void)
+{
+  int x = 1;
+  q = &x;
+  assert(*q == 1);
+}
+
+int main()
+{
+  struct s *p = &g;
+  p->a = 1;
+  p->b = p->a + p->a + p->a;
+  assert(p->b == 3);
+  f();
+  return *q;
+}
@@ -0,0 +1,10 @@
+int nondet_int();
+
+int main()
+{
+  int x = nondet_int();
+  int a = (x + 1) * (x + 1);
+  int b = (x + 1) * (x + 1);
+  assert(a == b);
+  return 0;
+}
@@ -0,0 +1,22 @@
+#include <assert.h>
+
+unsigned int nondet_uint();
+
+// Large enough to be unbounded, so every access goes through the array
+// flattener with a symbolic index
+int a[200000];
+
+int main()
+{
+  unsigned int i = nondet_uint(), j = nondet_uint(), k = nondet_uint();
+  __ESBMC_assume(i < 200000 && j < 200000 && k < 200000);
+
+  a[i] = 1;
+  a[j] = 2;
+  int x = a[k];
+
+  // Fails when k == i and i != j
+  assert(x != 1);
+
+  return 0;
+}
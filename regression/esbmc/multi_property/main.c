@@ -0,0 +1,11 @@
+int nondet_int();
+
+int main()
+{
+  int x = nondet_int();
+  assert(x != 5);
+  assert(x != 7);
+  if(x > 10)
+    assert(x > 5);
+  return 0;
+}
@@ -0,0 +1,16 @@
+int nondet_int();
+
+int a[4], b[4];
+
+int main()
+{
+  int i = nondet_int(), j = nondet_int();
+  __ESBMC_assume(i >= 0 && i < 4);
+
+  a[i] = i;
+  assert(a[i] < 4);
+
+  b[1] = j;
+  assert(b[1] != 3);
+  return 0;
+}
@@ -0,0 +1,10 @@
+int nondet_int();
+
+int main()
+{
+  int x = nondet_int();
+  int y = x * 3;
+  if(x > 0 && x < 100)
+    assert(y != 42);
+  return 0;
+}
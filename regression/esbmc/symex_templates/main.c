@@ -0,0 +1,10 @@
+int buf[8];
+
+int main()
+{
+  int *p = buf;
+  int sum = 0;
+  for(int i = 0; i <= 8; i++)
+    sum += p[i];
+  return sum;
+}
@@ -0,0 +1,32 @@
+// The condition of each loop gets a bounds check, which goto_check inserts
+// in front of the backwards goto: both loops must still be numbered, so
+// that --unwindset finds the second one.
+
+int a[4] = {1, 1, 0, 0};
+
+int f()
+{
+  int i = 0;
+  do
+  {
+    i++;
+  } while(a[i] != 0);
+  return i;
+}
+
+int g()
+{
+  int i = 0;
+  do
+  {
+    i++;
+  } while(a[i] != 0);
+  return i;
+}
+
+int main()
+{
+  f();
+  g();
+  return 0;
+}
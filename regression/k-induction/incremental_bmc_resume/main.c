@@ -0,0 +1,10 @@
+int main()
+{
+  unsigned int i, sum = 0;
+  for(i = 0; i < 100; i++)
+  {
+    sum += i;
+    assert(i != 6);
+  }
+  return sum;
+}
@@ -0,0 +1,9 @@
+int main()
+{
+  unsigned int i, sum = 0;
+  for(i = 0; i < 20; i++)
+  {
+    sum += i;
+    assert(sum < 30);
+  }
+}
@@ -0,0 +1,96 @@
+#!/bin/sh
+
+# Compare the two ways of dereferencing a pointer that may point at many
+# objects: a balanced tree of if-then-else (the default) against a linear
+# chain (--linear-case-split). For each pool size, a program is generated
+# that allocates that many heap objects, picks one nondeterministically and
+# reads through the pointer to it. ESBMC is run on it both ways, and the
+# run time and peak RSS of each are reported.
+
+usage() {
+  echo "Usage: case_split_bench.sh [opts] [pool_size ...]" >&2
+  echo "Options:" >&2
+  echo "    -e esbmc       ESBMC binary to run (default: esbmc in PATH)" >&2
+  echo "    -s solver      Solver option to pass, e.g. -s --z3 (default:" >&2
+  echo "                   ESBMC's default solver)" >&2
+  echo "    -T num_secs    Time limit for each run (default: 300)" >&2
+  echo "With no pool sizes, 100 250 500 1000 are run." >&2
+}
+
+esbmc=esbmc
+solver=
+numsecs=300
+while getopts "e:s:T:h" opt; do
+  case $opt in
+    e)
+      esbmc=$OPTARG
+      ;;
+    s)
+      solver=$OPTARG
+      ;;
+    T)
+      numsecs=$OPTARG
+      ;;
+    *)
+      usage
+      exit 1
+      ;;
+  esac
+done
+shift $((OPTIND - 1))
+
+if test $# -eq 0; then
+  set -- 100 250 500 1000
+fi
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+run() {
+  out="$dir/out"
+  start=$(date +%s.%N)
+  timeout "$numsecs" "$esbmc" "$dir/main.c" --force-malloc-success \
+    --unwind $(($1 + 1)) --no-unwinding-assertions --memstats $solver $2 \
+    > "$out" 2>&1
+  end=$(date +%s.%N)
+
+  if grep -q "^VERIFICATION FAILED$" "$out"; then
+    total=$(echo "$end - $start" | bc)
+  else
+    total=-
+  fi
+  peak=$(sed -n 's/^VmHWM:[ \t]*\([0-9]*\) kB$/\1/p' "$out")
+  printf " %10s %10s" "$total" "${peak:--}"
+}
+
+printf "%8s %10s %10s %10s %10s\n" objects tree_s tree_kb chain_s chain_kb
+for n in "$@"; do
+  cat > "$dir/main.c" <<EOF
+#include <assert.h>
+#include <stdlib.h>
+
+int nondet_int();
+
+int *pool[$n];
+
+int main()
+{
+  for(int i = 0; i < $n; i++)
+  {
+    pool[i] = (int *)malloc(sizeof(int));
+    *pool[i] = i;
+  }
+
+  int k = nondet_int();
+  __ESBMC_assume(k >= 0 && k < $n);
+  int *p = pool[k];
+  assert(*p != $n / 2);
+  return 0;
+}
+EOF
+
+  printf "%8s" "$n"
+  run "$n" ""
+  run "$n" --linear-case-split
+  printf "\n"
+done
@@ -0,0 +1,63 @@
+#!/bin/sh
+
+# Run ESBMC over the multi-threaded regression tests and report, for each,
+# how many execution states were cloned at context switch points, the time
+# spent cloning them, the total run time and the peak RSS. Meant for
+# comparing builds that change how execution_statet is copied.
+
+usage() {
+  echo "Usage: clone_bench.sh [opts] [testdir ...]" >&2
+  echo "Options:" >&2
+  echo "    -e esbmc       ESBMC binary to run (default: esbmc in PATH)" >&2
+  echo "    -T num_secs    Time limit for each test (default: 300)" >&2
+  echo "With no test directories, every test under regression/esbmc and" >&2
+  echo "regression/esbmc-unix that creates a pthread is run." >&2
+}
+
+esbmc=esbmc
+numsecs=300
+while getopts "e:T:h" opt; do
+  case $opt in
+    e)
+      esbmc=$OPTARG
+      ;;
+    T)
+      numsecs=$OPTARG
+      ;;
+    *)
+      usage
+      exit 1
+      ;;
+  esac
+done
+shift $((OPTIND - 1))
+
+regressiondir=$(cd "$(dirname "$0")/../regression" && pwd)
+
+if test $# -eq 0; then
+  set -- $(grep -l pthread_create "$regressiondir"/esbmc/*/*.c \
+    "$regressiondir"/esbmc-unix/*/*.c | xargs -n 1 dirname | sort -u)
+fi
+
+printf "%-40s %8s %10s %10s %10s\n" test clones clone_s total_s peak_kb
+for dir in "$@"; do
+  desc="$dir/test.desc"
+  test -f "$desc" || continue
+  file=$(sed -n 2p "$desc")
+  args=$(sed -n 3p "$desc")
+
+  out=$(mktemp)
+  start=$(date +%s.%N)
+  (cd "$dir" && timeout "$numsecs" "$esbmc" $file $args --memstats) \
+    > "$out" 2>&1
+  end=$(date +%s.%N)
+
+  clones=$(sed -n 's/^Execution state clones: \([0-9]*\) in \(.*\)s$/\1/p' "$out")
+  clonetime=$(sed -n 's/^Execution state clones: \([0-9]*\) in \(.*\)s$/\2/p' "$out")
+  peak=$(sed -n 's/^VmHWM:[ \t]*\([0-9]*\) kB$/\1/p' "$out")
+  total=$(echo "$end - $start" | bc)
+
+  printf "%-40s %8s %10s %10s %10s\n" "$(basename "$dir")" \
+    "${clones:--}" "${clonetime:--}" "$total" "${peak:--}"
+  rm -f "$out"
+done
@@ -0,0 +1,117 @@
+#!/bin/sh
+
+# Compare the time the symex slicer takes in two ESBMC builds, typically one
+# from before a change to slice.cpp and one from after. For each size, a
+# program is generated that updates a set of variables in a loop unwound that
+# many times, so the slicer has many steps and many symbols to track. Both
+# builds are run on it, and the slicing time of each is reported in seconds
+# per million SSA steps, along with the speedup of the second over the first.
+
+usage() {
+  echo "Usage: slice_bench.sh [opts] -b baseline [unwind ...]" >&2
+  echo "Options:" >&2
+  echo "    -b baseline    ESBMC binary to compare against" >&2
+  echo "    -e esbmc       ESBMC binary to measure (default: esbmc in PATH)" >&2
+  echo "    -s solver      Solver option to pass, e.g. -s --z3 (default:" >&2
+  echo "                   ESBMC's default solver)" >&2
+  echo "    -T num_secs    Time limit for each run (default: 300)" >&2
+  echo "With no unwinding bounds, 1000 5000 20000 are run." >&2
+}
+
+baseline=
+esbmc=esbmc
+solver=
+numsecs=300
+while getopts "b:e:s:T:h" opt; do
+  case $opt in
+    b)
+      baseline=$OPTARG
+      ;;
+    e)
+      esbmc=$OPTARG
+      ;;
+    s)
+      solver=$OPTARG
+      ;;
+    T)
+      numsecs=$OPTARG
+      ;;
+    *)
+      usage
+      exit 1
+      ;;
+  esac
+done
+shift $((OPTIND - 1))
+
+if test -z "$baseline"; then
+  usage
+  exit 1
+fi
+
+if test $# -eq 0; then
+  set -- 1000 5000 20000
+fi
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+# Prints the number of SSA steps and the slicing time in seconds per million
+# steps, or - for each if the run didn't get as far as slicing
+run() {
+  out="$dir/out"
+  timeout "$numsecs" "$1" "$dir/main.c" --unwind $(($2 + 1)) \
+    --no-unwinding-assertions $solver > "$out" 2>&1
+
+  steps=$(sed -n 's/^Symex completed in: .* (\([0-9]*\) assignments)$/\1/p' \
+    "$out")
+  slice=$(sed -n 's/^Slicing time: \([0-9.]*\)s .*$/\1/p' "$out")
+  if test -z "$steps" || test -z "$slice" || test "$steps" -eq 0; then
+    echo "- -"
+  else
+    echo "$steps $(echo "scale=3; $slice * 1000000 / $steps" | bc)"
+  fi
+}
+
+printf "%8s %10s %12s %12s %8s\n" unwind steps base_s/M new_s/M speedup
+for n in "$@"; do
+  cat > "$dir/main.c" <<EOF
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int a = nondet_int(), b = nondet_int(), c = nondet_int(), d = nondet_int();
+  int e = nondet_int(), f = nondet_int(), g = nondet_int(), h = nondet_int();
+
+  for(int i = 0; i < $n; i++)
+  {
+    a = b + i;
+    b = c ^ a;
+    c = d - b;
+    d = e + c;
+    e = f ^ d;
+    f = g - e;
+    g = h + f;
+    h = a ^ g;
+  }
+
+  assert(a != 42 || h != 42);
+  return 0;
+}
+EOF
+
+  base=$(run "$baseline" "$n")
+  new=$(run "$esbmc" "$n")
+  base_rate=${base#* }
+  new_rate=${new#* }
+  if test "$base_rate" = - || test "$new_rate" = - ||
+    test "$(echo "$new_rate == 0" | bc)" -eq 1; then
+    speedup=-
+  else
+    speedup=$(echo "scale=2; $base_rate / $new_rate" | bc)
+  fi
+  printf "%8s %10s %12s %12s %8s\n" "$n" "${new%% *}" "$base_rate" \
+    "$new_rate" "$speedup"
+done
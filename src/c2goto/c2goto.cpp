@@ -1,3 +1,4 @@
+#include <c2goto/cprover_library.h>
 #include <fstream>
 #include <goto-programs/goto_convert_functions.h>
 #include <goto-programs/write_goto_binary.h>
@@ -44,10 +45,17 @@ public:
     if(typecheck())
       return 1;
 
+    // Let add_cprover_library read only the symbols a program needs
+    symbol_depst deps;
+    context.foreach_operand([&deps](const symbolt &s) {
+      generate_symbol_deps(s.id, s.value, deps);
+      generate_symbol_deps(s.id, s.type, deps);
+    });
+
     std::ofstream out(
       cmdline.getval("output"), std::ios::out | std::ios::binary);
 
-    if(write_goto_binary(out, context, goto_functions))
+    if(write_goto_binary(out, context, goto_functions, &deps))
     {
       std::cerr << "Failed to write C library to binary obj" << std::endl;
       return 1;
@@ -9,9 +9,16 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_ANSI_C_CPROVER_LIBRARY_H
 #define CPROVER_ANSI_C_CPROVER_LIBRARY_H
 
+#include <map>
 #include <util/context.h>
 #include <util/message.h>
 
 void add_cprover_library(contextt &context, message_handlert &message_handler);
 
+/** Record in deps the symbols that irep refers to, as dependencies of name */
+void generate_symbol_deps(
+  irep_idt name,
+  irept irep,
+  std::multimap<irep_idt, irep_idt> &deps);
+
 #endif
@@ -18,12 +18,16 @@
 #include <clang/Frontend/TextDiagnosticPrinter.h>
 #include <clang/Lex/PreprocessorOptions.h>
 #include <clang/Tooling/Tooling.h>
+#include <llvm/ADT/SmallString.h>
 #include <llvm/Option/ArgList.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/Path.h>
 
 std::unique_ptr<clang::ASTUnit> buildASTs(
   const std::string &intrinsics,
-  const std::vector<std::string> &compiler_args)
+  const std::vector<std::string> &compiler_args,
+  const std::vector<in_memory_filet> &in_memory_files)
 {
   // Create virtual file system to add clang's headers
   llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> OverlayFileSystem(
@@ -33,6 +37,14 @@ std::unique_ptr<clang::ASTUnit> buildASTs(
     new llvm::vfs::InMemoryFileSystem);
   OverlayFileSystem->pushOverlay(InMemoryFileSystem);
 
+  // The buffers aren't copied, they must outlive the AST
+  for(auto const &f : in_memory_files)
+    InMemoryFileSystem->addFile(
+      f.path,
+      0,
+      llvm::MemoryBuffer::getMemBuffer(
+        llvm::StringRef(f.data, f.size), f.path, false));
+
   llvm::IntrusiveRefCntPtr<clang::FileManager> Files(
     new clang::FileManager(clang::FileSystemOptions(), OverlayFileSystem));
 
@@ -115,3 +127,52 @@ std::unique_ptr<clang::ASTUnit> buildASTs(
 
   return std::move(unit);
 }
+
+std::unique_ptr<clang::ASTUnit> loadAST(const std::string &path)
+{
+  if(!llvm::sys::fs::exists(path))
+    return nullptr;
+
+  // The reader keeps a reference to this
+  static clang::PCHContainerOperations PCHContainerOps;
+
+  // A stale file isn't an error, it's just parsed again
+  llvm::IntrusiveRefCntPtr<clang::DiagnosticsEngine> Diagnostics =
+    clang::CompilerInstance::createDiagnostics(
+      new clang::DiagnosticOptions(), new clang::IgnoringDiagConsumer());
+
+  // Fails if the inputs recorded in the file have changed
+  return clang::ASTUnit::LoadFromASTFile(
+    path,
+    PCHContainerOps.getRawReader(),
+    clang::ASTUnit::LoadEverything,
+    Diagnostics,
+    clang::FileSystemOptions());
+}
+
+bool saveAST(clang::ASTUnit &unit, const std::string &path)
+{
+  // Only an AST that still has its semantic analysis can be serialized
+  if(!unit.hasSema())
+    return true;
+
+  // Write somewhere else first, so that no process reads half a file
+  llvm::SmallString<128> tmp;
+  if(llvm::sys::fs::createUniqueFile(path + ".tmp%%%%%%", tmp))
+    return true;
+
+  std::string tmp_path = tmp.str().str();
+  if(unit.Save(tmp_path))
+  {
+    llvm::sys::fs::remove(tmp_path);
+    return true;
+  }
+
+  if(llvm::sys::fs::rename(tmp_path, path))
+  {
+    llvm::sys::fs::remove(tmp_path);
+    return true;
+  }
+
+  return false;
+}
@@ -9,6 +9,7 @@
 #define CLANG_C_FRONTEND_AST_BUILD_AST_H_
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -21,8 +22,24 @@ namespace clang
 class ASTUnit;
 } // namespace clang
 
+/** A file that clang can read but that only exists in memory */
+struct in_memory_filet
+{
+  std::string path;
+  const char *data;
+  std::size_t size;
+};
+
 std::unique_ptr<clang::ASTUnit> buildASTs(
   const std::string &intrinsics,
-  const std::vector<std::string> &compiler_args);
+  const std::vector<std::string> &compiler_args,
+  const std::vector<in_memory_filet> &in_memory_files);
+
+/** Load an AST saved by saveAST. Returns nullptr if it can't be loaded,
+ *  including when a file it was built from has changed since. */
+std::unique_ptr<clang::ASTUnit> loadAST(const std::string &path);
+
+/** Save the AST to path; returns true on error */
+bool saveAST(clang::ASTUnit &unit, const std::string &path);
 
 #endif /* CLANG_C_FRONTEND_AST_BUILD_AST_H_ */
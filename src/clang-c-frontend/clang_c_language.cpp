@@ -15,8 +15,13 @@ Author: Daniel Kroening, kroening@cs.cmu.edu
 #include <clang-c-frontend/clang_c_language.h>
 #include <clang-c-frontend/clang_c_main.h>
 #include <clang-c-frontend/expr2c.h>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
 #include <sstream>
 #include <util/c_link.h>
+#include <util/config.h>
+#include <util/fast_hash.h>
 
 languaget *new_clang_c_language()
 {
@@ -25,31 +30,43 @@ languaget *new_clang_c_language()
 
 clang_c_languaget::clang_c_languaget()
 {
-  // Create a temporary directory, to dump clang's headers
-  auto p = boost::filesystem::temp_directory_path();
-  if(!boost::filesystem::exists(p) || !boost::filesystem::is_directory(p))
+  ast_cache_dir = config.options.get_option("ast-cache-dir");
+  if(ast_cache_dir.empty())
   {
-    std::cerr << "Can't find temporary directory (needed to dump clang headers)"
-              << std::endl;
-    abort();
+    // clang finds its headers in memory, under a directory that doesn't
+    // exist on disk
+    std::string dir = "/esbmc_clang_headers";
+    headers = get_clang_headers(dir);
+    build_compiler_args(std::move(dir));
+    return;
   }
 
-  // Create temporary directory
-  p += "/esbmc_clang_headers";
-  boost::filesystem::create_directory(p);
-  if(!boost::filesystem::is_directory(p))
+  // Cached ASTs refer to the headers they were built from, so those have to
+  // be on disk and stay there. Keep one copy per set of headers.
+  fast_hash h;
+  for(auto const &it : get_clang_headers(""))
   {
-    std::cerr
-      << "Can't create temporary directory (needed to dump clang headers)"
-      << std::endl;
+    h.ingest(it.path.c_str(), it.path.size());
+    h.ingest(it.data, it.size);
+  }
+  h.fin();
+
+  std::ostringstream dir;
+  dir << ast_cache_dir << "/clang_headers_" << std::hex << h.hash[0];
+
+  boost::filesystem::create_directories(dir.str());
+  if(!boost::filesystem::is_directory(dir.str()))
+  {
+    std::cerr << "Can't create directory " << dir.str()
+              << " (needed to cache ASTs)" << std::endl;
     abort();
   }
 
   // Build the compile arguments
-  build_compiler_args(std::move(p.string()));
+  build_compiler_args(dir.str());
 
-  // Dump clang headers on the temporary folder
-  dump_clang_headers(p.string());
+  // Dump clang headers on the cache folder
+  dump_clang_headers(dir.str());
 }
 
 void clang_c_languaget::build_compiler_args(const std::string &&tmp_dir)
@@ -197,8 +214,25 @@ bool clang_c_languaget::parse(
   // Get intrinsics
   std::string intrinsics = internal_additions();
 
+  std::string cache_file;
+  if(!ast_cache_dir.empty())
+  {
+    cache_file = ast_cache_file(path, new_compiler_args, intrinsics);
+
+    // Only ASTs without errors are saved
+    auto AST = loadAST(cache_file);
+    if(AST)
+    {
+      ASTs.push_back(std::move(AST));
+      return false;
+    }
+  }
+
   // Generate ASTUnit and add to our vector
-  auto AST = buildASTs(intrinsics, new_compiler_args);
+  auto AST = buildASTs(intrinsics, new_compiler_args, headers);
+
+  if(!cache_file.empty() && !AST->getDiagnostics().hasErrorOccurred())
+    saveAST(*AST, cache_file);
 
   ASTs.push_back(std::move(AST));
 
@@ -210,6 +244,30 @@ bool clang_c_languaget::parse(
   return false;
 }
 
+std::string clang_c_languaget::ast_cache_file(
+  const std::string &path,
+  const std::vector<std::string> &args,
+  const std::string &intrinsics) const
+{
+  // Headers the input includes are recorded in the AST file, and checked
+  // when it's loaded
+  fast_hash h;
+  for(auto const &arg : args)
+    h.ingest(arg.c_str(), arg.size() + 1);
+  h.ingest(intrinsics.c_str(), intrinsics.size());
+
+  std::ifstream in(path, std::ios::binary);
+  std::string contents(
+    (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  h.ingest(contents.c_str(), contents.size());
+  h.fin();
+
+  std::ostringstream file;
+  file << ast_cache_dir << "/" << std::hex << std::setfill('0')
+       << std::setw(16) << h.hash[0] << std::setw(16) << h.hash[1] << ".ast";
+  return file.str();
+}
+
 bool clang_c_languaget::typecheck(
   contextt &context,
   const std::string &module,
@@ -295,6 +353,9 @@ _Bool __ESBMC_is_little_endian();
 int __ESBMC_rounding_mode = 0;
 
 void *__ESBMC_memset(void *, int, unsigned int);
+void *__ESBMC_memcpy(void *, const void *, __SIZE_TYPE__);
+void *__ESBMC_memmove(void *, const void *, __SIZE_TYPE__);
+__SIZE_TYPE__ __ESBMC_strlen(const char *);
 
 // Forward decs for pthread main thread begin/end hooks. Because they're
 // pulled in from the C library, they need to be declared prior to pulling
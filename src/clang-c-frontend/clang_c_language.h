@@ -9,6 +9,7 @@ Author:
 #ifndef CLANG_C_FRONTEND_CLANG_C_LANGUAGE_H_
 #define CLANG_C_FRONTEND_CLANG_C_LANGUAGE_H_
 
+#include <clang-c-frontend/AST/build_ast.h>
 #include <util/language.h>
 
 #define __STDC_LIMIT_MACROS
@@ -72,11 +73,24 @@ protected:
   virtual std::string internal_additions();
   virtual void force_file_type();
 
+  /** clang's own headers, as if they were in dir */
+  std::vector<in_memory_filet> get_clang_headers(const std::string &dir);
   void dump_clang_headers(const std::string &tmp_dir);
   void build_compiler_args(const std::string &&tmp_dir);
 
+  /** Name of the file the AST of this input is cached in */
+  std::string ast_cache_file(
+    const std::string &path,
+    const std::vector<std::string> &args,
+    const std::string &intrinsics) const;
+
   std::vector<std::string> compiler_args;
   std::vector<std::unique_ptr<clang::ASTUnit>> ASTs;
+
+  /** clang's headers, served from memory; empty if they were dumped */
+  std::vector<in_memory_filet> headers;
+  /** Where parsed ASTs are kept between runs (--ast-cache-dir), if at all */
+  std::string ast_cache_dir;
 };
 
 languaget *new_clang_c_language();
@@ -1,4 +1,5 @@
 #include <clang-c-frontend/clang_c_language.h>
+#include <boost/filesystem.hpp>
 #include <fstream>
 
 struct hooked_header
@@ -597,6 +598,16 @@ extern "C"
     {nullptr, nullptr, nullptr}};
 }
 
+std::vector<in_memory_filet>
+clang_c_languaget::get_clang_headers(const std::string &dir)
+{
+  std::vector<in_memory_filet> headers;
+  for(struct hooked_header *h = &clang_headers[0]; h->basename != nullptr; h++)
+    headers.push_back({dir + "/" + h->basename, h->textstart, *h->textsize});
+
+  return headers;
+}
+
 void clang_c_languaget::dump_clang_headers(const std::string &tmp_dir)
 {
   static bool dumped = false;
@@ -604,11 +615,15 @@ void clang_c_languaget::dump_clang_headers(const std::string &tmp_dir)
     return;
   dumped = true;
 
-  for(struct hooked_header *h = &clang_headers[0]; h->basename != nullptr; h++)
+  for(auto const &h : get_clang_headers(tmp_dir))
   {
+    // Rewriting a header would make the ASTs built from it look stale
+    if(boost::filesystem::exists(h.path))
+      continue;
+
     std::ofstream header;
-    header.open(tmp_dir + "/" + std::string(h->basename));
-    header << std::string(h->textstart, *h->textsize);
+    header.open(h.path);
+    header << std::string(h.data, h.size);
     header.close();
   }
 }
@@ -11,6 +11,8 @@ Authors: Daniel Kroening, kroening@kroening.com
 #include <sys/types.h>
 
 #ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #else
 #include <windows.h>
@@ -20,6 +22,7 @@ Authors: Daniel Kroening, kroening@kroening.com
 #endif
 
 #include <ac_config.h>
+#include <atomic>
 #include <esbmc/bmc.h>
 #include <esbmc/document_subgoals.h>
 #include <fstream>
@@ -86,6 +89,19 @@ void bmct::do_cbmc(
   std::shared_ptr<symex_target_equationt> &eq)
 {
   smt_conv->set_message_handler(message_handler);
+
+  if(options.get_bool_option("incremental-solver"))
+  {
+    unsigned int reused =
+      eq->convert_incremental(*smt_conv.get(), encoded_eq.get());
+    encoded_eq = eq;
+
+    std::ostringstream str;
+    str << "Reused the encoding of " << reused << " SSA steps";
+    status(str.str());
+    return;
+  }
+
   eq->convert(*smt_conv.get());
 }
 
@@ -212,9 +228,15 @@ smt_convt::resultt bmct::run_decision_procedure(
   status(ss.str());
 
   fine_timet sat_start = current_time();
-  smt_convt::resultt dec_result = smt_conv->dec_solve();
+  smt_convt::resultt dec_result = smt_conv->solve_with_refinement();
   fine_timet sat_stop = current_time();
 
+  // Every assertion checked by now holds, don't check them on the next run
+  if(
+    dec_result == smt_convt::P_UNSATISFIABLE &&
+    options.get_bool_option("incremental-solver"))
+    eq->discharge_assertions();
+
   // output runtime
   str.clear();
   str << "\nRuntime decision procedure: ";
@@ -225,6 +247,397 @@ smt_convt::resultt bmct::run_decision_procedure(
   return dec_result;
 }
 
+smt_convt::resultt bmct::solve_standalone(
+  const std::string &solver_name,
+  std::shared_ptr<symex_target_equationt> &eq)
+{
+  try
+  {
+    std::shared_ptr<smt_convt> smt_conv(create_solver_factory(
+      solver_name, options.get_bool_option("int-encoding"), ns, options));
+    smt_conv->set_message_handler(message_handler);
+    smt_conv->set_verbosity(get_verbosity());
+
+    eq->convert(*smt_conv.get());
+    return smt_conv->solve_with_refinement();
+  }
+
+  catch(std::string &error_str)
+  {
+    error(error_str);
+  }
+
+  catch(const char *error_str)
+  {
+    error(error_str);
+  }
+
+  catch(std::bad_alloc &)
+  {
+    std::cout << "Out of memory" << std::endl;
+  }
+
+  return smt_convt::P_ERROR;
+}
+
+unsigned long bmct::forked_workers(const std::string &option) const
+{
+  unsigned long workers =
+    strtoul(options.get_option(option).c_str(), nullptr, 10);
+#ifndef _WIN32
+  if(workers == 0)
+  {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    workers = online > 0 ? online : 1;
+  }
+#endif
+  return workers == 0 ? 1 : workers;
+}
+
+bool bmct::start_forked(std::vector<forked_jobt> &jobs, std::size_t index)
+{
+  fine_timet start = current_time();
+#ifndef _WIN32
+  // The child reports its result through its exit status
+  std::cout.flush();
+  pid_t pid = fork();
+  if(pid == -1)
+    return false;
+
+  if(!pid)
+    _exit(solve_standalone(jobs[index].solver, jobs[index].eq));
+
+  forked_running[pid] = std::make_pair(index, start);
+#else
+  // No fork, solve it right away and let wait_forked pick up the result
+  jobs[index].result = solve_standalone(jobs[index].solver, jobs[index].eq);
+  jobs[index].time = current_time() - start;
+  jobs[index].finished = true;
+  forked_running[-1 - long(index)] = std::make_pair(index, start);
+#endif
+  return true;
+}
+
+std::size_t bmct::wait_forked(std::vector<forked_jobt> &jobs)
+{
+  while(!forked_running.empty())
+  {
+#ifndef _WIN32
+    int exit_status;
+    pid_t pid = waitpid(-1, &exit_status, 0);
+    if(pid == -1)
+      break;
+
+    auto it = forked_running.find(pid);
+    if(it == forked_running.end())
+      continue;
+
+    forked_jobt &job = jobs[it->second.first];
+    job.finished = true;
+    job.time = current_time() - it->second.second;
+    job.result = WIFEXITED(exit_status)
+                   ? smt_convt::resultt(WEXITSTATUS(exit_status))
+                   : smt_convt::P_ERROR;
+#else
+    auto it = forked_running.begin();
+#endif
+    std::size_t index = it->second.first;
+    forked_running.erase(it);
+    return index;
+  }
+
+  return jobs.size();
+}
+
+void bmct::kill_forked(std::vector<forked_jobt> &jobs)
+{
+#ifndef _WIN32
+  for(auto const &it : forked_running)
+  {
+    kill(it.first, SIGKILL);
+    waitpid(it.first, nullptr, 0);
+    jobs[it.second.first].time = current_time() - it.second.second;
+  }
+#else
+  (void)jobs;
+#endif
+  forked_running.clear();
+}
+
+std::size_t bmct::run_forked(
+  std::vector<forked_jobt> &jobs,
+  unsigned long workers,
+  bool any_answer)
+{
+  std::size_t next = 0;
+  while(true)
+  {
+    while(next < jobs.size() && forked_running.size() < workers)
+    {
+      if(!start_forked(jobs, next))
+        break;
+      ++next;
+    }
+
+    std::size_t index = wait_forked(jobs);
+    if(index == jobs.size())
+    {
+      if(next < jobs.size())
+        error("Fork failed, cannot start the decision procedures");
+      return jobs.size();
+    }
+
+    smt_convt::resultt res = jobs[index].result;
+    if(
+      res == smt_convt::P_SATISFIABLE ||
+      (any_answer && res == smt_convt::P_UNSATISFIABLE))
+    {
+      kill_forked(jobs);
+      return index;
+    }
+  }
+}
+
+smt_convt::resultt bmct::solve_partitions(
+  std::vector<std::shared_ptr<symex_target_equationt>> &partitions,
+  std::shared_ptr<symex_target_equationt> &eq)
+{
+  {
+    std::ostringstream str;
+    str << "Split the VCCs into " << partitions.size()
+        << " independent partitions";
+    status(str.str());
+  }
+
+  std::vector<forked_jobt> jobs;
+  for(auto &partition : partitions)
+    jobs.push_back({"", partition, smt_convt::P_ERROR, false, 0});
+
+  fine_timet sat_start = current_time();
+  std::size_t failed =
+    run_forked(jobs, forked_workers("partition-workers"), false);
+  fine_timet sat_stop = current_time();
+
+  std::ostringstream str;
+  str << "Runtime of the partitions' decision procedures: ";
+  output_time(sat_stop - sat_start, str);
+  str << "s";
+  status(str.str());
+
+  if(failed != jobs.size())
+  {
+    // Solve the failing partition again here, so that the counterexample can
+    // be built from the model.
+    eq = partitions[failed];
+    runtime_solver = std::shared_ptr<smt_convt>(create_solver_factory(
+      "", options.get_bool_option("int-encoding"), ns, options));
+    return run_decision_procedure(runtime_solver, eq);
+  }
+
+  for(auto const &job : jobs)
+    if(job.result != smt_convt::P_UNSATISFIABLE)
+      return smt_convt::P_ERROR;
+
+  return smt_convt::P_UNSATISFIABLE;
+}
+
+smt_convt::resultt
+bmct::portfolio_check(std::shared_ptr<symex_target_equationt> &eq)
+{
+  std::vector<forked_jobt> jobs;
+  for(auto const &solver : portfolio_solvers(options))
+    jobs.push_back({solver, eq, smt_convt::P_ERROR, false, 0});
+
+  {
+    std::ostringstream str;
+    str << "Racing " << jobs.size() << " solvers:";
+    for(auto const &job : jobs)
+      str << " " << job.solver;
+    status(str.str());
+  }
+
+  // Every solver gets a core of its own
+  std::size_t winner = run_forked(jobs, jobs.size(), true);
+
+  for(auto const &job : jobs)
+  {
+    std::ostringstream str;
+    str << "Portfolio: " << job.solver << " ";
+    if(!job.finished)
+      str << "killed after ";
+    else if(job.result == smt_convt::P_SATISFIABLE)
+      str << "SAT in ";
+    else if(job.result == smt_convt::P_UNSATISFIABLE)
+      str << "UNSAT in ";
+    else
+      str << "failed after ";
+    output_time(job.time, str);
+    str << "s";
+    status(str.str());
+  }
+
+  if(winner == jobs.size())
+    return smt_convt::P_ERROR;
+
+  if(jobs[winner].result == smt_convt::P_UNSATISFIABLE)
+    return smt_convt::P_UNSATISFIABLE;
+
+  // Solve again with the winner here, so that the counterexample can be
+  // built from its model.
+  runtime_solver = std::shared_ptr<smt_convt>(create_solver_factory(
+    jobs[winner].solver, options.get_bool_option("int-encoding"), ns, options));
+  return run_decision_procedure(runtime_solver, eq);
+}
+
+smt_convt::resultt bmct::multi_property_check(
+  std::shared_ptr<smt_convt> &smt_conv,
+  std::shared_ptr<symex_target_equationt> &eq)
+{
+  smt_conv->set_message_handler(message_handler);
+  smt_conv->set_verbosity(get_verbosity());
+
+  fine_timet encode_start = current_time();
+  smt_convt::ast_vec violations = eq->convert_steps(*smt_conv.get());
+  fine_timet encode_stop = current_time();
+
+  std::ostringstream str;
+  str << "Encoding to solver time: ";
+  output_time(encode_stop - encode_start, str);
+  str << "s";
+  status(str.str());
+
+  // A claim is one assertion in the goto program, which symex may have
+  // instantiated many times
+  struct claimt
+  {
+    const symex_target_equationt::SSA_stept *step;
+    smt_convt::ast_vec violations;
+    smt_astt activation;
+    tvt result;
+  };
+
+  std::vector<claimt> claims;
+  std::map<unsigned int, std::size_t> claim_map;
+
+  auto vit = violations.begin();
+  for(auto const &step : eq->SSA_steps)
+  {
+    if(!step.is_assert() || step.ignore)
+      continue;
+
+    assert(vit != violations.end());
+    auto res = claim_map.emplace(step.source.pc->location_number, claims.size());
+    if(res.second)
+      claims.push_back({&step, {}, nullptr, tvt(tvt::TV_UNKNOWN)});
+    claims[res.first->second].violations.push_back(*vit++);
+  }
+
+  // Guard each claim's violation with its own activation literal; a decided
+  // claim is retired by asserting its literal false, so the solver can keep
+  // everything it learnt between calls.
+  smt_convt::ast_vec any_violation;
+  for(auto &claim : claims)
+  {
+    claim.activation = smt_conv->mk_fresh(smt_conv->boolean_sort, "claim");
+    any_violation.push_back(smt_conv->mk_and(
+      claim.activation,
+      smt_conv->make_n_ary(
+        smt_conv.get(), &smt_convt::mk_or, claim.violations)));
+  }
+
+  if(!any_violation.empty())
+    smt_conv->assert_ast(smt_conv->make_n_ary(
+      smt_conv.get(), &smt_convt::mk_or, any_violation));
+
+  std::stringstream ss;
+  ss << "Solving " << claims.size() << " claims with solver "
+     << smt_conv->solver_text();
+  status(ss.str());
+
+  fine_timet sat_start = current_time();
+  std::size_t pending = claims.size();
+  while(pending != 0)
+  {
+    smt_convt::resultt res = smt_conv->solve_with_refinement();
+    if(res == smt_convt::P_UNSATISFIABLE)
+    {
+      for(auto &claim : claims)
+        if(claim.result.is_unknown())
+          claim.result = tvt(tvt::TV_TRUE);
+      break;
+    }
+
+    if(res != smt_convt::P_SATISFIABLE)
+      break;
+
+    error_trace(smt_conv, eq);
+
+    std::size_t failed = 0;
+    for(auto &claim : claims)
+    {
+      if(!claim.result.is_unknown())
+        continue;
+
+      for(auto const &v : claim.violations)
+      {
+        if(smt_conv->l_get(v).is_true())
+        {
+          claim.result = tvt(tvt::TV_FALSE);
+          smt_conv->assert_ast(smt_conv->invert_ast(claim.activation));
+          ++failed;
+          break;
+        }
+      }
+    }
+
+    // The model must violate some pending claim; if the solver can't tell us
+    // which, the rest stays unknown
+    if(failed == 0)
+      break;
+
+    pending -= failed;
+  }
+  fine_timet sat_stop = current_time();
+
+  str.str("");
+  str << "\nRuntime decision procedure: ";
+  output_time(sat_stop - sat_start, str);
+  str << "s";
+  status(str.str());
+
+  unsigned int num_pass = 0, num_fail = 0, num_unknown = 0;
+  std::cout << "\nClaim results:\n";
+  for(auto const &claim : claims)
+  {
+    if(claim.result.is_true())
+    {
+      std::cout << "  PASS     ";
+      ++num_pass;
+    }
+    else if(claim.result.is_false())
+    {
+      std::cout << "  FAIL     ";
+      ++num_fail;
+    }
+    else
+    {
+      std::cout << "  UNKNOWN  ";
+      ++num_unknown;
+    }
+
+    std::cout << claim.step->comment << " at "
+              << claim.step->source.pc->location << "\n";
+  }
+  std::cout << "\n"
+            << num_pass << " passed, " << num_fail << " failed, "
+            << num_unknown << " unknown\n";
+
+  if(num_fail != 0)
+    return smt_convt::P_SATISFIABLE;
+
+  return num_unknown != 0 ? smt_convt::P_ERROR : smt_convt::P_UNSATISFIABLE;
+}
+
 void bmct::report_success()
 {
   status("\nVERIFICATION SUCCESSFUL");
@@ -369,6 +782,11 @@ void bmct::report_trace(
   bool term = options.get_bool_option("termination");
   bool show_cex = options.get_bool_option("show-cex");
 
+  // Each counterexample was already shown as its claims were refuted, or by
+  // the --parallel-dfs process that found it
+  if(options.get_bool_option("multi-property") || trace_reported)
+    return;
+
   switch(res)
   {
   case smt_convt::P_UNSATISFIABLE:
@@ -467,6 +885,16 @@ smt_convt::resultt bmct::start_bmc()
   return res;
 }
 
+/* State of a --parallel-dfs search, in memory shared by its processes. The
+ * claim table for reachability_treet::share_dfs follows it. */
+struct bmct::shared_dfst
+{
+  std::atomic<bool> stop;
+  std::atomic<bool> trace_reported;
+  std::atomic<unsigned int> interleavings;
+  std::atomic<unsigned int> failed;
+};
+
 smt_convt::resultt bmct::run(std::shared_ptr<symex_target_equationt> &eq)
 {
   symex->options.set_option("unwind", options.get_option("unwind"));
@@ -475,6 +903,18 @@ smt_convt::resultt bmct::run(std::shared_ptr<symex_target_equationt> &eq)
   if(options.get_bool_option("schedule"))
     return run_thread(eq);
 
+  if(options.get_bool_option("parallel-interleavings"))
+    return run_parallel(eq);
+
+  if(options.get_bool_option("parallel-dfs"))
+    return run_shared_dfs(eq);
+
+  return run_interleavings(eq);
+}
+
+smt_convt::resultt
+bmct::run_interleavings(std::shared_ptr<symex_target_equationt> &eq)
+{
   smt_convt::resultt res;
   do
   {
@@ -516,11 +956,213 @@ smt_convt::resultt bmct::run(std::shared_ptr<symex_target_equationt> &eq)
     if(options.get_bool_option("interactive-ileaves"))
       return res;
 
+    // Another process of --parallel-dfs found a bug
+    if(shared_dfs != nullptr && shared_dfs->stop)
+      return res;
+
   } while(symex->setup_next_formula());
 
   return interleaving_failed > 0 ? smt_convt::P_SATISFIABLE : res;
 }
 
+smt_convt::resultt
+bmct::run_shared_dfs(std::shared_ptr<symex_target_equationt> &eq)
+{
+#ifndef _WIN32
+  unsigned long workers = forked_workers("dfs-workers");
+  unsigned int split_depth =
+    strtoul(options.get_option("dfs-split-depth").c_str(), nullptr, 10);
+  const unsigned int num_claims = 1 << 20;
+
+  std::size_t size =
+    sizeof(shared_dfst) + num_claims * sizeof(std::atomic<bool>);
+  void *mem = mmap(
+    nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if(mem == MAP_FAILED)
+  {
+    error("Cannot map memory for the shared search");
+    return smt_convt::P_ERROR;
+  }
+
+  // Anonymous mappings are zeroed, which is false and 0 for the atomics
+  shared_dfs = new(mem) shared_dfst;
+  std::atomic<bool> *claims = reinterpret_cast<std::atomic<bool> *>(
+    static_cast<char *>(mem) + sizeof(shared_dfst));
+
+  std::vector<pid_t> children;
+  std::cout.flush();
+  for(unsigned int w = 0; w < workers; w++)
+  {
+    pid_t pid = fork();
+    if(pid == -1)
+      break;
+
+    if(pid)
+    {
+      children.push_back(pid);
+      continue;
+    }
+
+    // Each process runs the usual search, skipping what others claimed
+    symex->share_dfs(claims, num_claims, split_depth, w, workers);
+    smt_convt::resultt res = run_interleavings(eq);
+
+    shared_dfs->interleavings += interleaving_number.to_uint64();
+    shared_dfs->failed += interleaving_failed.to_uint64();
+    if(res == smt_convt::P_SATISFIABLE)
+    {
+      if(!options.get_bool_option("all-runs"))
+        shared_dfs->stop = true;
+
+      // Only the first counterexample is shown
+      if(!shared_dfs->trace_reported.exchange(true))
+        report_trace(res, eq);
+    }
+
+    std::cout.flush();
+    _exit(res);
+  }
+
+  bool failed = false, had_error = children.empty();
+  for(std::size_t i = 0; i < children.size(); i++)
+  {
+    int exit_status;
+    pid_t pid = waitpid(-1, &exit_status, 0);
+    if(pid == -1)
+      break;
+
+    smt_convt::resultt res = WIFEXITED(exit_status)
+                               ? smt_convt::resultt(WEXITSTATUS(exit_status))
+                               : smt_convt::P_ERROR;
+    if(res == smt_convt::P_SATISFIABLE)
+    {
+      failed = true;
+      if(!options.get_bool_option("all-runs"))
+      {
+        for(pid_t child : children)
+          if(child != pid)
+            kill(child, SIGKILL);
+      }
+    }
+    else if(res != smt_convt::P_UNSATISFIABLE && !shared_dfs->stop)
+      had_error = true;
+  }
+
+  interleaving_number = shared_dfs->interleavings.load();
+  interleaving_failed = shared_dfs->failed.load();
+  munmap(mem, size);
+  shared_dfs = nullptr;
+
+  if(failed)
+  {
+    // The counterexample was shown by the process that found it
+    trace_reported = true;
+    return smt_convt::P_SATISFIABLE;
+  }
+
+  return had_error ? smt_convt::P_ERROR : smt_convt::P_UNSATISFIABLE;
+#else
+  return run_interleavings(eq);
+#endif
+}
+
+smt_convt::resultt
+bmct::run_parallel(std::shared_ptr<symex_target_equationt> &eq)
+{
+  unsigned long workers = forked_workers("interleaving-workers");
+  bool all_runs = options.get_bool_option("all-runs");
+
+  // Symex keeps generating interleavings while the children solve them
+  std::vector<forked_jobt> jobs;
+  std::size_t failed = 0;
+  bool found = false, more = true, stop = false;
+  smt_convt::resultt res = smt_convt::P_UNSATISFIABLE;
+  while(!stop)
+  {
+    while(more && !stop && forked_running.size() < workers)
+    {
+      if(++interleaving_number > 1)
+      {
+        std::cout << "*** Thread interleavings " << interleaving_number
+                  << " ***" << std::endl;
+      }
+
+      std::shared_ptr<symex_target_equationt> ileave_eq;
+      bool ready = false;
+      smt_convt::resultt ileave_res = generate_vccs(ileave_eq, ready);
+      more = symex->setup_next_formula();
+
+      if(!ready)
+      {
+        if(ileave_res)
+        {
+          res = ileave_res;
+          stop = !all_runs;
+        }
+        continue;
+      }
+
+      jobs.push_back({"", ileave_eq, smt_convt::P_ERROR, false, 0});
+      if(!start_forked(jobs, jobs.size() - 1))
+      {
+        error("Fork failed, cannot solve the interleaving");
+        res = smt_convt::P_ERROR;
+        stop = true;
+      }
+    }
+
+    if(stop)
+      break;
+
+    std::size_t index = wait_forked(jobs);
+    if(index == jobs.size())
+    {
+      if(!more)
+        break;
+      continue;
+    }
+
+    forked_jobt &job = jobs[index];
+    if(job.result == smt_convt::P_SATISFIABLE)
+    {
+      ++interleaving_failed;
+      if(!found)
+      {
+        found = true;
+        failed = index;
+      }
+      stop = !all_runs;
+    }
+    else if(job.result != smt_convt::P_UNSATISFIABLE)
+    {
+      res = smt_convt::P_ERROR;
+      stop = !all_runs;
+    }
+
+    // Only the first failing interleaving is needed for the counterexample
+    if(!found || failed != index)
+      job.eq.reset();
+  }
+
+  kill_forked(jobs);
+
+  if(!found)
+    return res;
+
+  // Solve the failing interleaving again here, so that the counterexample
+  // can be built from the model.
+  eq = jobs[failed].eq;
+  runtime_solver = std::shared_ptr<smt_convt>(create_solver_factory(
+    "", options.get_bool_option("int-encoding"), ns, options));
+  if(run_decision_procedure(runtime_solver, eq) != smt_convt::P_SATISFIABLE)
+    return smt_convt::P_ERROR;
+
+  if(config.options.get_bool_option("smt-model"))
+    runtime_solver->print_model();
+
+  return smt_convt::P_SATISFIABLE;
+}
+
 void bmct::bidirectional_search(
   std::shared_ptr<smt_convt> &smt_conv,
   std::shared_ptr<symex_target_equationt> &eq)
@@ -652,6 +1294,17 @@ void bmct::bidirectional_search(
 }
 
 smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
+{
+  bool ready = false;
+  smt_convt::resultt res = generate_vccs(eq, ready);
+  if(!ready)
+    return res;
+
+  return solve_vccs(eq);
+}
+
+smt_convt::resultt
+bmct::generate_vccs(std::shared_ptr<symex_target_equationt> &eq, bool &ready)
 {
   std::shared_ptr<goto_symext::symex_resultt> result;
 
@@ -690,6 +1343,13 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
 
   fine_timet symex_stop = current_time();
 
+  // Another process of --parallel-dfs checks this interleaving
+  if(!symex->formula_is_ours())
+  {
+    --interleaving_number;
+    return smt_convt::P_UNSATISFIABLE;
+  }
+
   eq = std::dynamic_pointer_cast<symex_target_equationt>(result->target);
 
   {
@@ -701,6 +1361,18 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
     status(str.str());
   }
 
+  // The table is only needed while symex builds the steps; the next
+  // interleaving starts from an empty one
+  if(eq->get_intern_table())
+  {
+    std::ostringstream str;
+    str << "Interned " << eq->get_intern_table()->size()
+        << " unique expressions (" << eq->get_intern_table()->merged()
+        << " duplicates merged)";
+    status(str.str());
+    eq->get_intern_table()->clear();
+  }
+
   if(options.get_bool_option("double-assign-check"))
     eq->check_for_duplicate_assigns();
 
@@ -719,7 +1391,15 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
       str << "Slicing time: ";
       output_time(slice_stop - slice_start, str);
       str << "s";
-      str << " (removed " << ignored << " assignments)";
+      str << " (removed " << ignored << " assignments";
+      if(!eq->SSA_steps.empty())
+      {
+        str << ", ";
+        output_time(
+          (slice_stop - slice_start) * 1000000 / eq->SSA_steps.size(), str);
+        str << "s per million steps";
+      }
+      str << ")";
       status(str.str());
     }
 
@@ -763,12 +1443,61 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
       return smt_convt::P_UNSATISFIABLE;
     }
 
-    if(!options.get_bool_option("smt-during-symex"))
+    ready = true;
+    return smt_convt::P_UNSATISFIABLE;
+  }
+
+  catch(std::string &error_str)
+  {
+    error(error_str);
+    return smt_convt::P_ERROR;
+  }
+
+  catch(const char *error_str)
+  {
+    error(error_str);
+    return smt_convt::P_ERROR;
+  }
+
+  catch(std::bad_alloc &)
+  {
+    std::cout << "Out of memory" << std::endl;
+    return smt_convt::P_ERROR;
+  }
+}
+
+smt_convt::resultt
+bmct::solve_vccs(std::shared_ptr<symex_target_equationt> &eq)
+{
+  try
+  {
+    // The formula dumps need a single solver
+    bool dump_formula = options.get_bool_option("smt-formula-too") ||
+                        options.get_bool_option("smt-formula-only");
+
+    if(options.get_bool_option("partition-assertions") && !dump_formula)
+    {
+      std::vector<std::shared_ptr<symex_target_equationt>> partitions =
+        partition_assertions(eq);
+      if(!partitions.empty())
+        return solve_partitions(partitions, eq);
+    }
+
+    if(options.get_bool_option("portfolio") && !dump_formula)
+      return portfolio_check(eq);
+
+    // With --incremental-solver the solver is kept across runs
+    if(
+      !options.get_bool_option("smt-during-symex") &&
+      !(options.get_bool_option("incremental-solver") && runtime_solver))
     {
       runtime_solver = std::shared_ptr<smt_convt>(create_solver_factory(
         "", options.get_bool_option("int-encoding"), ns, options));
     }
 
+    if(options.get_bool_option("multi-property"))
+      return multi_property_check(runtime_solver, eq);
+
     return run_decision_procedure(runtime_solver, eq);
   }
 
@@ -17,7 +17,9 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <solvers/smt/smt_conv.h>
 #include <solvers/smtlib/smtlib_conv.h>
 #include <solvers/solve.h>
+#include <sys/types.h>
 #include <util/options.h>
+#include <util/time_stopping.h>
 
 class bmct : public messaget
 {
@@ -47,6 +49,14 @@ protected:
   namespacet ns;
   std::shared_ptr<smt_convt> runtime_solver;
   std::shared_ptr<reachability_treet> symex;
+  /** Processes of --parallel-dfs share this; nullptr otherwise */
+  struct shared_dfst;
+  shared_dfst *shared_dfs = nullptr;
+  /** The counterexample was already shown by a --parallel-dfs process */
+  bool trace_reported = false;
+
+  /** Last equation encoded into runtime_solver with --incremental-solver */
+  std::shared_ptr<symex_target_equationt> encoded_eq;
 
   // use gui format
   language_uit::uit ui;
@@ -55,6 +65,55 @@ protected:
     std::shared_ptr<smt_convt> &smt_conv,
     std::shared_ptr<symex_target_equationt> &eq);
 
+  virtual smt_convt::resultt multi_property_check(
+    std::shared_ptr<smt_convt> &smt_conv,
+    std::shared_ptr<symex_target_equationt> &eq);
+
+  virtual smt_convt::resultt solve_partitions(
+    std::vector<std::shared_ptr<symex_target_equationt>> &partitions,
+    std::shared_ptr<symex_target_equationt> &eq);
+
+  virtual smt_convt::resultt
+  portfolio_check(std::shared_ptr<symex_target_equationt> &eq);
+
+  /** A decision procedure to run in a process of its own */
+  struct forked_jobt
+  {
+    std::string solver;
+    std::shared_ptr<symex_target_equationt> eq;
+    smt_convt::resultt result;
+    bool finished;
+    fine_timet time;
+  };
+
+  /** Children solving forked_jobts: the job's index and start time by pid */
+  std::map<pid_t, std::pair<std::size_t, fine_timet>> forked_running;
+
+  /** Number of children to run at once given by a numeric option, where 0
+   *  stands for one per CPU */
+  unsigned long forked_workers(const std::string &option) const;
+
+  /** Start solving jobs[index] in a forked child; false if fork failed */
+  bool start_forked(std::vector<forked_jobt> &jobs, std::size_t index);
+
+  /** Wait for a child to finish and record its result in its job. Returns
+   *  the job's index, or jobs.size() if no child is running. */
+  std::size_t wait_forked(std::vector<forked_jobt> &jobs);
+
+  void kill_forked(std::vector<forked_jobt> &jobs);
+
+  /** Solve the jobs in forked children, at most `workers` at a time, until
+   *  one is satisfiable or, with any_answer, unsatisfiable. Returns the index
+   *  of that job, or jobs.size() if there was none. */
+  std::size_t run_forked(
+    std::vector<forked_jobt> &jobs,
+    unsigned long workers,
+    bool any_answer);
+
+  smt_convt::resultt solve_standalone(
+    const std::string &solver_name,
+    std::shared_ptr<symex_target_equationt> &eq);
+
   virtual void do_cbmc(
     std::shared_ptr<smt_convt> &smt_conv,
     std::shared_ptr<symex_target_equationt> &eq);
@@ -85,6 +144,25 @@ protected:
     std::shared_ptr<symex_target_equationt> &eq);
 
   smt_convt::resultt run_thread(std::shared_ptr<symex_target_equationt> &eq);
+
+  /** Like run, but the interleavings are solved by forked children while
+   *  symex goes on to the next ones */
+  smt_convt::resultt run_parallel(std::shared_ptr<symex_target_equationt> &eq);
+
+  /** Check each interleaving in turn */
+  smt_convt::resultt
+  run_interleavings(std::shared_ptr<symex_target_equationt> &eq);
+
+  /** Split the interleavings between processes that claim subtrees of the
+   *  reachability tree from each other as they go (--parallel-dfs) */
+  smt_convt::resultt
+  run_shared_dfs(std::shared_ptr<symex_target_equationt> &eq);
+
+  /** Run symex for the next interleaving and slice its equation. Sets ready
+   *  if eq is left with VCCs to solve; otherwise the result is returned. */
+  smt_convt::resultt
+  generate_vccs(std::shared_ptr<symex_target_equationt> &eq, bool &ready);
+  smt_convt::resultt solve_vccs(std::shared_ptr<symex_target_equationt> &eq);
 };
 
 #endif
@@ -38,9 +38,10 @@ extern "C"
 #include <goto-programs/goto_convert_functions.h>
 #include <goto-programs/goto_inline.h>
 #include <goto-programs/goto_k_induction.h>
+#include <goto-programs/goto_pass_manager.h>
 #include <goto-programs/interval_analysis.h>
 #include <goto-programs/loop_numbers.h>
-#include <goto-programs/read_goto_binary.h>
+#include <goto-programs/read_bin_goto_object.h>
 #include <goto-programs/remove_skip.h>
 #include <goto-programs/remove_unreachable.h>
 #include <goto-programs/set_claims.h>
@@ -49,9 +50,11 @@ extern "C"
 #include <langapi/languages.h>
 #include <langapi/mode.h>
 #include <memory>
+#include <pointer-analysis/dereference.h>
 #include <pointer-analysis/goto_program_dereference.h>
 #include <pointer-analysis/show_value_sets.h>
 #include <pointer-analysis/value_set_analysis.h>
+#include <util/simplify_cache.h>
 #include <util/symbol.h>
 #include <sys/wait.h>
 #include <util/time_stopping.h>
@@ -184,6 +187,9 @@ void esbmc_parseoptionst::get_command_line_options(optionst &options)
 
   options.cmdline(cmdline);
 
+  simplify_cachet::set_capacity(
+    strtoul(cmdline.getval("simplify-cache-size"), nullptr, 10));
+
   /* graphML generation options check */
   if(cmdline.isset("witness-output"))
     options.set_option("witness-output", cmdline.getval("witness-output"));
@@ -257,6 +263,115 @@ void esbmc_parseoptionst::get_command_line_options(optionst &options)
     }
   }
 
+  if(cmdline.isset("multi-property") && cmdline.isset("smt-during-symex"))
+  {
+    std::cerr << "--multi-property can't be used with --smt-during-symex"
+              << std::endl;
+    abort();
+  }
+
+  if(cmdline.isset("fast-state-hashing"))
+    options.set_option("state-hashing", true);
+
+  if(cmdline.isset("parallel-dfs"))
+  {
+    // All the processes must number the subtrees in the same order
+    if(
+      options.get_bool_option("state-hashing") || cmdline.isset("schedule") ||
+      cmdline.isset("round-robin") || cmdline.isset("interactive-ileaves") ||
+      cmdline.isset("parallel-interleavings"))
+    {
+      std::cerr << "--parallel-dfs can't be used with --state-hashing, "
+                   "--schedule, --round-robin, --interactive-ileaves or "
+                   "--parallel-interleavings"
+                << std::endl;
+      abort();
+    }
+  }
+
+  if(cmdline.isset("parallel-interleavings"))
+  {
+    // Each interleaving is solved on its own in a child process
+    if(
+      cmdline.isset("smt-during-symex") || cmdline.isset("multi-property") ||
+      cmdline.isset("incremental-solver") ||
+      cmdline.isset("partition-assertions") || cmdline.isset("portfolio") ||
+      cmdline.isset("interactive-ileaves") || cmdline.isset("bidirectional"))
+    {
+      std::cerr << "--parallel-interleavings can't be used with "
+                   "--smt-during-symex, --multi-property, "
+                   "--incremental-solver, --partition-assertions, "
+                   "--portfolio, --interactive-ileaves or --bidirectional"
+                << std::endl;
+      abort();
+    }
+  }
+
+  if(cmdline.isset("portfolio"))
+  {
+    // The solvers to race are given by --portfolio-solvers
+    if(
+      cmdline.isset("smtlib") || cmdline.isset("z3") ||
+      cmdline.isset("boolector") || cmdline.isset("mathsat") ||
+      cmdline.isset("cvc") || cmdline.isset("yices"))
+    {
+      std::cerr << "--portfolio picks its own solvers, use "
+                   "--portfolio-solvers to choose them"
+                << std::endl;
+      abort();
+    }
+
+    if(
+      cmdline.isset("smt-during-symex") || cmdline.isset("multi-property") ||
+      cmdline.isset("incremental-solver") ||
+      cmdline.isset("partition-assertions"))
+    {
+      std::cerr << "--portfolio can't be used with --smt-during-symex, "
+                   "--multi-property, --incremental-solver or "
+                   "--partition-assertions"
+                << std::endl;
+      abort();
+    }
+  }
+
+  if(cmdline.isset("partition-assertions"))
+  {
+    // Partitions are built from the symbol ids the slicer records
+    if(
+      cmdline.isset("no-slice") || cmdline.isset("smt-during-symex") ||
+      cmdline.isset("multi-property") || cmdline.isset("incremental-solver"))
+    {
+      std::cerr << "--partition-assertions can't be used with --no-slice, "
+                   "--smt-during-symex, --multi-property or "
+                   "--incremental-solver"
+                << std::endl;
+      abort();
+    }
+  }
+
+  if(cmdline.isset("incremental-solver"))
+  {
+    // The solver's own assertion stack is needed to retract the encoding of
+    // steps that changed between runs
+    if(
+      !cmdline.isset("z3") && !cmdline.isset("yices") &&
+      !cmdline.isset("mathsat"))
+    {
+      std::cerr << "--incremental-solver needs a solver with push/pop "
+                   "support (--z3, --yices or --mathsat)"
+                << std::endl;
+      abort();
+    }
+
+    if(cmdline.isset("smt-during-symex") || cmdline.isset("multi-property"))
+    {
+      std::cerr << "--incremental-solver can't be used with "
+                   "--smt-during-symex or --multi-property"
+                << std::endl;
+      abort();
+    }
+  }
+
   if(cmdline.isset("base-case"))
   {
     options.set_option("base-case", true);
@@ -1222,8 +1337,8 @@ int esbmc_parseoptionst::do_base_case(
   opts.set_option("no-unwinding-assertions", true);
   opts.set_option("partial-loops", false);
 
-  bmct bmc(goto_functions, opts, context, ui_message_handler);
-  set_verbosity_msg(bmc);
+  std::unique_ptr<bmct> scratch;
+  bmct &bmc = get_k_step_bmc(base_case_bmc, scratch, opts, goto_functions);
 
   bmc.options.set_option("unwind", integer2string(k_step));
 
@@ -1285,8 +1400,9 @@ int esbmc_parseoptionst::do_forward_condition(
   // Turn assertions off
   opts.set_option("no-assertions", true);
 
-  bmct bmc(goto_functions, opts, context, ui_message_handler);
-  set_verbosity_msg(bmc);
+  std::unique_ptr<bmct> scratch;
+  bmct &bmc =
+    get_k_step_bmc(forward_condition_bmc, scratch, opts, goto_functions);
 
   bmc.options.set_option("unwind", integer2string(k_step));
 
@@ -1344,8 +1460,8 @@ int esbmc_parseoptionst::do_inductive_step(
   opts.set_option("no-unwinding-assertions", true);
   opts.set_option("partial-loops", true);
 
-  bmct bmc(goto_functions, opts, context, ui_message_handler);
-  set_verbosity_msg(bmc);
+  std::unique_ptr<bmct> scratch;
+  bmct &bmc = get_k_step_bmc(inductive_step_bmc, scratch, opts, goto_functions);
 
   bmc.options.set_option("unwind", integer2string(k_step));
 
@@ -1374,6 +1490,24 @@ int esbmc_parseoptionst::do_inductive_step(
   return true;
 }
 
+bmct &esbmc_parseoptionst::get_k_step_bmc(
+  std::unique_ptr<bmct> &kept,
+  std::unique_ptr<bmct> &scratch,
+  optionst &opts,
+  goto_functionst &goto_functions)
+{
+  std::unique_ptr<bmct> &bmc =
+    opts.get_bool_option("incremental-solver") ? kept : scratch;
+
+  if(!bmc)
+  {
+    bmc.reset(new bmct(goto_functions, opts, context, ui_message_handler));
+    set_verbosity_msg(*bmc);
+  }
+
+  return *bmc;
+}
+
 bool esbmc_parseoptionst::set_claims(goto_functionst &goto_functions)
 {
   try
@@ -1544,15 +1678,25 @@ void esbmc_parseoptionst::preprocessing()
 
 bool esbmc_parseoptionst::read_goto_binary(goto_functionst &goto_functions)
 {
-  std::ifstream in(cmdline.getval("binary"), std::ios::binary);
+  goto_binary_readert reader(*get_message_handler());
 
-  if(!in)
+  if(reader.open(cmdline.getval("binary")))
   {
     error(std::string("Failed to open `") + cmdline.getval("binary") + "'");
     return true;
   }
 
-  ::read_goto_binary(in, context, goto_functions, *get_message_handler());
+  if(reader.read_symbols(context, goto_functions))
+    return true;
+
+  // Only deserialize the bodies that verification can reach
+  if(!reader.load_reachable(goto_functions.main_id(), context, goto_functions))
+    reader.load_all(goto_functions);
+
+  std::ostringstream str;
+  str << "Loaded " << reader.num_loaded_functions() << " of "
+      << reader.num_functions() << " function bodies";
+  status(str.str());
 
   return false;
 }
@@ -1621,21 +1765,21 @@ bool esbmc_parseoptionst::process_goto_program(
       goto_functions, ns, context, options, value_set_analysis);
 #endif
 
-    // remove skips
-    remove_skip(goto_functions);
-
-    // remove unreachable code
-    Forall_goto_functions(f_it, goto_functions)
-      remove_unreachable(f_it->second.body);
-
-    // remove skips
-    remove_skip(goto_functions);
-
-    // recalculate numbers, etc.
-    goto_functions.update();
-
-    // add loop ids
-    goto_functions.compute_loop_numbers();
+    // remove skips, unreachable code and skips again, a function per thread;
+    // then recalculate numbers and add loop ids
+    goto_pass_managert passes(
+      goto_functions,
+      strtoul(cmdline.getval("preprocess-workers"), nullptr, 10));
+    goto_pass_managert::passt skips =
+      [](goto_programt &body, goto_programt::instructionst &removed) {
+        remove_skip(body, removed);
+      };
+    passes.add(skips);
+    passes.add([](goto_programt &body, goto_programt::instructionst &) {
+      remove_unreachable(body);
+    });
+    passes.add(skips);
+    passes.run();
 
     if(cmdline.isset("data-races-check"))
     {
@@ -1700,6 +1844,15 @@ int esbmc_parseoptionst::do_bmc(bmct &bmc)
   if(res == smt_convt::P_ERROR)
     abort();
 
+  if(bmc.options.get_bool_option("memstats"))
+  {
+    simplify_cachet::print_stats(std::cerr);
+    reachability_treet::print_clone_stats(std::cerr);
+  }
+
+  if(bmc.options.get_bool_option("deref-memo-stats"))
+    dereferencet::memot::print_stats(std::cerr);
+
 #ifdef HAVE_SENDFILE_ESBMC
   if(bmc.options.get_bool_option("memstats"))
   {
@@ -1768,6 +1921,9 @@ void esbmc_parseoptionst::help()
        " --preprocess                 stop after preprocessing\n"
        " --no-inlining                disable inlining function calls\n"
        " --full-inlining              perform full inlining of function calls\n"
+       " --preprocess-workers nr      number of threads cleaning up the goto "
+       "functions\n"
+       "                              (default is the number of CPUs)\n"
        " --all-claims                 keep all claims\n"
        " --show-loops                 show the loops in the program\n"
        " --show-claims                only show claims\n"
@@ -1777,6 +1933,10 @@ void esbmc_parseoptionst::help()
        " --no-library                 disable built-in abstract C library\n"
        " --binary                     read goto program instead of source "
        "code\n"
+       " --ast-cache-dir path         keep the parsed source in path, and "
+       "reuse it\n"
+       "                              while the input and options don't "
+       "change\n"
        " --little-endian              allow little-endian word-byte "
        "conversions\n"
        " --big-endian                 allow big-endian word-byte conversions\n"
@@ -1818,6 +1978,15 @@ void esbmc_parseoptionst::help()
        " --no-slice                   do not remove unused equations\n"
        " --extended-try-analysis      check all the try block, even when an "
        "exception is thrown\n"
+       " --multi-property             check each claim on its own and report "
+       "which ones\n"
+       "                              pass, fail or are unknown\n"
+       " --partition-assertions       solve groups of assertions with disjoint "
+       "cones of\n"
+       "                              influence in parallel processes\n"
+       " --partition-workers nr       number of processes for "
+       "--partition-assertions\n"
+       "                              (default is the number of CPUs)\n"
 
        "\nIncremental BMC\n"
        " --falsification              incremental loop unwinding for bug "
@@ -1857,6 +2026,17 @@ void esbmc_parseoptionst::help()
        "--tuple-sym-flattener         encode tuples using our tuple to symbol "
        "API\n"
        "--array-flattener             encode arrays using our array API\n"
+       "--lazy-array-constraints      with our array API, only add the array "
+       "constraints\n"
+       "                              that a model violates, solving again "
+       "until none is\n"
+       "                              left\n"
+       " --portfolio                  race several solvers on each VCC and "
+       "take the\n"
+       "                              first answer\n"
+       " --portfolio-solvers list     comma separated solvers to race (default "
+       "is all\n"
+       "                              solvers built in but smtlib)\n"
        "--no-return-value-opt         disable return value optimization to "
        "compute the stack size\n"
 
@@ -1903,6 +2083,13 @@ void esbmc_parseoptionst::help()
        " --unlimited-k-steps          set max number of iteration to UINT_MAX\n"
        " --show-cex                   print the counter-example produced by "
        "the inductive step\n"
+       " --incremental-solver         keep one solver per step across "
+       "iterations, only encoding\n"
+       "                              the SSA steps that changed and "
+       "resuming symex where the\n"
+       "                              last iteration first hit the "
+       "unwinding bound (needs\n"
+       "                              --z3, --yices or --mathsat)\n"
 
        "\nScheduling approaches\n"
        " --schedule                   use schedule recording approach \n"
@@ -1918,9 +2105,26 @@ void esbmc_parseoptionst::help()
        "each thread \n"
        " --state-hashing              enable state-hashing, prunes duplicate "
        "states\n"
+       " --fast-state-hashing         state-hashing with a fast 128-bit "
+       "non-cryptographic\n"
+       "                              hash, updated on each assignment\n"
        " --no-por                     do not do partial order reduction\n"
        " --all-runs                   check all interleavings, even if a bug "
        "was already found\n"
+       " --parallel-dfs               split the search for interleavings "
+       "between\n"
+       "                              processes that claim subtrees as they go\n"
+       " --dfs-workers nr             number of processes for --parallel-dfs\n"
+       "                              (default is the number of CPUs)\n"
+       " --dfs-split-depth nr         context switches explored by every "
+       "process before\n"
+       "                              subtrees are claimed (default is 2)\n"
+       " --parallel-interleavings     solve interleavings in parallel processes "
+       "while\n"
+       "                              symex generates the next ones\n"
+       " --interleaving-workers nr    number of processes for "
+       "--parallel-interleavings\n"
+       "                              (default is the number of CPUs)\n"
        " --initial-context-bound nr   set the initial context-bound for "
        "incremental verification (default is 2)\n"
        " --context-bound-step nr      set k context bound increment (default "
@@ -1937,7 +2141,25 @@ void esbmc_parseoptionst::help()
        "by {s,m,h}\n"
        " --memstats                   print memory usage statistics\n"
        " --no-simplify                do not simplify any expression\n"
+       " --simplify-cache-size nr     number of simplified expressions to "
+       "remember,\n"
+       "                              e.g. 65536 (default is 0, no cache)\n"
        " --no-propagation             disable constant propagation\n"
+       " --intern-exprs               share one node between equal expressions "
+       "in the\n"
+       "                              SSA steps\n"
+       " --symex-templates            reuse the dereferenced form of "
+       "expressions met again\n"
+       "                              with the same pointer targets, as in "
+       "unrolled loops\n"
+       " --no-deref-memo              do not reuse the dereference of a "
+       "pointer whose\n"
+       "                              value set hasn't changed since\n"
+       " --deref-memo-stats           print how often dereferences were "
+       "reused\n"
+       " --linear-case-split          dereference pointers to several objects "
+       "with a chain\n"
+       "                              of if-then-else, not a balanced tree\n"
        " --enable-core-dump           do not disable core dump output\n"
        " --interval-analysis          enable interval analysis and add assumes "
        "to the program\n"
@@ -62,6 +62,12 @@ protected:
     goto_functionst &goto_functions,
     const BigInt &k_step);
 
+  bmct &get_k_step_bmc(
+    std::unique_ptr<bmct> &kept,
+    std::unique_ptr<bmct> &scratch,
+    optionst &opts,
+    goto_functionst &goto_functions);
+
   bool read_goto_binary(goto_functionst &goto_functions);
 
   bool set_claims(goto_functionst &goto_functions);
@@ -90,6 +96,12 @@ private:
   int initial_context_bound;
   int max_context_bound;
   int context_bound_inc;
+
+  /* bmct objects kept alive across k-steps by --incremental-solver, so each
+   * step keeps its symex and solver state */
+  std::unique_ptr<bmct> base_case_bmc;
+  std::unique_ptr<bmct> forward_condition_bmc;
+  std::unique_ptr<bmct> inductive_step_bmc;
 };
 
 #endif
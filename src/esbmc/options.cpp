@@ -45,6 +45,7 @@ const struct opt_templ esbmc_options[] = {
   {0, "preprocess", switc, ""},
   {0, "no-inlining", switc, ""},
   {0, "full-inlining", switc, ""},
+  {0, "preprocess-workers", number, "0"},
   {0, "all-claims", switc, ""},
   {0, "show-loops", switc, ""},
   {0, "show-claims", switc, ""},
@@ -53,6 +54,7 @@ const struct opt_templ esbmc_options[] = {
   {0, "no-arch", switc, ""},
   {0, "no-library", switc, ""},
   {0, "binary", string, ""},
+  {0, "ast-cache-dir", string, ""},
   {0, "little-endian", switc, ""},
   {0, "big-endian", switc, ""},
   {0, "16", switc, ""},
@@ -83,6 +85,9 @@ const struct opt_templ esbmc_options[] = {
   {0, "extended-try-analysis", switc, ""},
   {0, "skip-bmc", switc, ""},
   {0, "no-return-value-opt", switc, ""},
+  {0, "multi-property", switc, ""},
+  {0, "partition-assertions", switc, ""},
+  {0, "partition-workers", number, "0"},
 
   // IBMC
   {0, "incremental-bmc", switc, ""},
@@ -107,6 +112,9 @@ const struct opt_templ esbmc_options[] = {
   {0, "tuple-node-flattener", switc, ""},
   {0, "tuple-sym-flattener", switc, ""},
   {0, "array-flattener", switc, ""},
+  {0, "lazy-array-constraints", switc, ""},
+  {0, "portfolio", switc, ""},
+  {0, "portfolio-solvers", string, ""},
 
   // Incremental SMT
   {0, "smt-during-symex", switc, ""},
@@ -142,6 +150,7 @@ const struct opt_templ esbmc_options[] = {
   {0, "show-cex", switc, ""},
   {0, "bidirectional", switc, ""},
   {0, "max-inductive-step", number, "-1"},
+  {0, "incremental-solver", switc, ""},
 
   // Scheduling
   {0, "schedule", switc, ""},
@@ -151,8 +160,14 @@ const struct opt_templ esbmc_options[] = {
   // Concurrency checking
   {0, "context-bound", number, "-1"},
   {0, "state-hashing", switc, ""},
+  {0, "fast-state-hashing", switc, ""},
   {0, "no-por", switc, ""},
   {0, "all-runs", switc, ""},
+  {0, "parallel-interleavings", switc, ""},
+  {0, "interleaving-workers", number, "0"},
+  {0, "parallel-dfs", switc, ""},
+  {0, "dfs-workers", number, "0"},
+  {0, "dfs-split-depth", number, "2"},
   {0, "incremental-cb", switc, ""},
   {0, "context-bound-step", number, "5"},
   {0, "max-context-bound", number, "15"},
@@ -165,7 +180,13 @@ const struct opt_templ esbmc_options[] = {
   {0, "timeout", string, ""},
   {0, "enable-core-dump", switc, ""},
   {0, "no-simplify", switc, ""},
+  {0, "simplify-cache-size", number, "0"},
   {0, "no-propagation", switc, ""},
+  {0, "intern-exprs", switc, ""},
+  {0, "symex-templates", switc, ""},
+  {0, "no-deref-memo", switc, ""},
+  {0, "deref-memo-stats", switc, ""},
+  {0, "linear-case-split", switc, ""},
   {0, "interval-analysis", switc, ""},
 
   // DEBUG options
@@ -0,0 +1,96 @@
+/*******************************************************************\
+
+Module: Running per-function passes over goto functions in parallel
+
+\*******************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <goto-programs/goto_pass_manager.h>
+#include <thread>
+
+goto_pass_managert::goto_pass_managert(
+  goto_functionst &_goto_functions,
+  unsigned _workers)
+  : goto_functions(_goto_functions), workers(_workers)
+{
+  if(workers == 0)
+    workers = std::thread::hardware_concurrency();
+  if(workers == 0)
+    workers = 1;
+}
+
+void goto_pass_managert::for_each_job(
+  std::vector<jobt> &jobs,
+  const std::function<void(jobt &)> &f) const
+{
+  std::atomic<std::size_t> next(0);
+  auto worker = [&jobs, &f, &next]() {
+    for(std::size_t i = next++; i < jobs.size(); i = next++)
+      f(jobs[i]);
+  };
+
+  std::size_t num_threads = std::min<std::size_t>(workers, jobs.size());
+  if(num_threads <= 1)
+  {
+    worker();
+    return;
+  }
+
+  // This thread takes jobs too
+  std::vector<std::thread> threads;
+  for(std::size_t i = 1; i < num_threads; i++)
+    threads.emplace_back(worker);
+  worker();
+
+  for(auto &t : threads)
+    t.join();
+}
+
+void goto_pass_managert::run()
+{
+  std::vector<jobt> jobs(goto_functions.function_map.size());
+  std::size_t i = 0;
+  for(auto &it : goto_functions.function_map)
+    jobs[i++].body = &it.second.body;
+
+  for_each_job(jobs, [this](jobt &job) {
+    goto_programt &body = *job.body;
+    for(const auto &pass : passes)
+      pass(body, job.removed);
+
+    body.compute_target_numbers();
+
+    // is_backwards_goto compares location numbers, which the passes leave
+    // stale: number this body on its own for now
+    body.compute_location_numbers();
+
+    job.locations = body.instructions.size();
+    job.loops = 0;
+    for(const auto &instruction : body.instructions)
+      if(instruction.is_backwards_goto())
+        job.loops++;
+  });
+
+  // Hand out the numbers in function_map order, as compute_location_numbers
+  // and compute_loop_numbers would
+  std::vector<std::pair<unsigned, unsigned>> first(jobs.size());
+  unsigned location_nr = 0, loop_nr = 1;
+  for(i = 0; i < jobs.size(); i++)
+  {
+    first[i] = std::make_pair(location_nr, loop_nr);
+    location_nr += jobs[i].locations;
+    loop_nr += jobs[i].loops;
+  }
+
+  for_each_job(jobs, [&jobs, &first](jobt &job) {
+    const auto &nr = first[&job - jobs.data()];
+    unsigned location = nr.first, loop = nr.second;
+    job.body->compute_location_numbers(location);
+    job.body->compute_loop_numbers(loop);
+  });
+
+  // Release what the passes removed on this thread
+  for(auto &job : jobs)
+    job.removed.clear();
+}
@@ -0,0 +1,72 @@
+/*******************************************************************\
+
+Module: Running per-function passes over goto functions in parallel
+
+\*******************************************************************/
+
+#ifndef CPROVER_GOTO_PROGRAMS_GOTO_PASS_MANAGER_H
+#define CPROVER_GOTO_PROGRAMS_GOTO_PASS_MANAGER_H
+
+#include <functional>
+#include <goto-programs/goto_functions.h>
+#include <vector>
+
+/**
+ *  Runs a pipeline of passes over each function body on a pool of threads.
+ *  Each thread takes the next function not yet claimed and runs every pass
+ *  on it in turn, then recomputes its target numbers.
+ *
+ *  Only passes that rearrange the instructions of the body they're given
+ *  may be added. irept reference counts and the string table aren't thread
+ *  safe, so a pass must not create or destroy ireps, locations or names:
+ *  instructions it takes out of the body go into `removed`, and are
+ *  destroyed by run() once the threads are done.
+ *
+ *  Location and loop numbers span functions. run() hands them out in
+ *  function_map order afterwards, so they don't depend on how the functions
+ *  were scheduled, and are the same as goto_functionst::update() gives.
+ */
+class goto_pass_managert
+{
+public:
+  typedef std::function<
+    void(goto_programt &body, goto_programt::instructionst &removed)>
+    passt;
+
+  /**
+   *  @param _goto_functions Functions to run the passes over.
+   *  @param _workers Number of threads to use, or 0 for one per CPU.
+   */
+  goto_pass_managert(goto_functionst &_goto_functions, unsigned _workers);
+
+  /** Add a pass to the end of the pipeline. */
+  void add(const passt &pass)
+  {
+    passes.push_back(pass);
+  }
+
+  /** Run the pipeline over every function and renumber the instructions. */
+  void run();
+
+protected:
+  goto_functionst &goto_functions;
+  unsigned workers;
+  std::vector<passt> passes;
+
+  /** Per function: its body, what the passes removed from it, and how many
+   *  location and loop numbers it needs */
+  struct jobt
+  {
+    goto_programt *body;
+    goto_programt::instructionst removed;
+    unsigned locations;
+    unsigned loops;
+  };
+
+  /** Run f(job) for every job, on up to `workers` threads */
+  void for_each_job(
+    std::vector<jobt> &jobs,
+    const std::function<void(jobt &)> &f) const;
+};
+
+#endif
@@ -8,17 +8,32 @@ Date: June 2006
 
 \*******************************************************************/
 
-#include <goto-programs/goto_function_serialization.h>
+#include <fstream>
 #include <goto-programs/goto_program_irep.h>
 #include <goto-programs/read_bin_goto_object.h>
+#include <goto-programs/write_goto_binary.h>
+#include <iterator>
 #include <langapi/mode.h>
 #include <util/base_type.h>
-#include <util/irep_serialization.h>
 #include <util/message_stream.h>
 #include <util/namespace.h>
-#include <util/symbol_serialization.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
-#define BINARY_VERSION 1
+/** Read only stream over a region of memory */
+class memory_streambuft : public std::streambuf
+{
+public:
+  memory_streambuft(const char *begin, const char *end)
+  {
+    char *b = const_cast<char *>(begin);
+    setg(b, b, const_cast<char *>(end));
+  }
+};
 
 bool read_bin_goto_object(
   std::istream &in,
@@ -26,6 +41,102 @@ bool read_bin_goto_object(
   contextt &context,
   goto_functionst &functions,
   message_handlert &message_handler)
+{
+  goto_binary_readert reader(message_handler);
+
+  if(reader.open(in, filename) || reader.read_symbols(context, functions))
+    return false;
+
+  reader.load_all(functions);
+  return false;
+}
+
+goto_binary_readert::goto_binary_readert(message_handlert &_message_handler)
+  : message_handler(_message_handler),
+    data(nullptr),
+    size(0),
+    mapping(nullptr),
+    irepconverter(ic),
+    symbolconverter(ic),
+    gfconverter(ic),
+    num_loaded(0),
+    index_read(false),
+    version(0),
+    symbols_offset(0)
+{
+}
+
+goto_binary_readert::~goto_binary_readert()
+{
+#ifndef _WIN32
+  if(mapping != nullptr)
+    munmap(mapping, size);
+#endif
+}
+
+bool goto_binary_readert::open(const std::string &_filename)
+{
+  filename = _filename;
+
+#ifndef _WIN32
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if(fd < 0)
+    return true;
+
+  struct stat st;
+  if(fstat(fd, &st) == 0 && st.st_size > 0)
+  {
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(p != MAP_FAILED)
+    {
+      mapping = p;
+      data = static_cast<const char *>(p);
+      size = st.st_size;
+    }
+  }
+  close(fd);
+
+  if(mapping != nullptr)
+    return false;
+#endif
+
+  // Couldn't map it, read it instead
+  std::ifstream in(filename, std::ios::binary);
+  if(!in)
+    return true;
+
+  return open(in, filename);
+}
+
+bool goto_binary_readert::open(std::istream &in, const std::string &_filename)
+{
+  filename = _filename;
+  buffer.assign(
+    std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  data = buffer.data();
+  size = buffer.size();
+  return false;
+}
+
+bool goto_binary_readert::open(
+  const char *_data,
+  std::size_t _size,
+  const std::string &_filename)
+{
+  filename = _filename;
+  data = _data;
+  size = _size;
+  return false;
+}
+
+uint64_t goto_binary_readert::read_offset(std::istream &in)
+{
+  uint64_t hi = irep_serializationt::read_long(in);
+  uint64_t lo = irep_serializationt::read_long(in);
+  return (hi << 32) | lo;
+}
+
+bool goto_binary_readert::read_header(std::istream &in)
 {
   message_streamt message_stream(message_handler);
 
@@ -53,32 +164,110 @@ bool read_bin_goto_object(
 
       message_stream.error();
 
-      return false;
+      return true;
     }
   }
 
-  irep_serializationt::ireps_containert ic;
-  irep_serializationt irepconverter(ic);
-  symbol_serializationt symbolconverter(ic);
-  goto_function_serializationt gfconverter(ic);
+  version = irepconverter.read_long(in);
 
+  // Version 1 had no index and is read start to end
+  if(version != 1 && version != GOTO_BINARY_VERSION)
   {
-    unsigned version = irepconverter.read_long(in);
+    message_stream.str << "The input was compiled with a different version of "
+                       << "goto-cc, please recompile";
+    message_stream.warning();
+    return true;
+  }
 
-    if(version != BINARY_VERSION)
-    {
-      message_stream.str
-        << "The input was compiled with a different version of "
-        << "goto-cc, please recompile";
-      message_stream.warning();
-      return false;
-    }
+  return false;
+}
+
+bool goto_binary_readert::read_index()
+{
+  if(index_read)
+    return false;
+
+  memory_streambuft buf(data, data + size);
+  std::istream in(&buf);
+
+  if(read_header(in))
+    return true;
+
+  if(version == 1)
+  {
+    symbols_offset = in.tellg();
+    index_read = true;
+    return false;
+  }
+
+  uint64_t index_offset = read_offset(in);
+  if(index_offset > size)
+  {
+    message_streamt message_stream(message_handler);
+    message_stream.str << "`" << filename << "' is truncated";
+    message_stream.error();
+    return true;
+  }
+
+  in.seekg(index_offset);
+  uint64_t strings_offset = read_offset(in);
+  symbols_offset = read_offset(in);
+
+  unsigned count = irepconverter.read_long(in);
+  for(unsigned i = 0; i < count; i++)
+  {
+    dstring fname = irepconverter.read_string(in);
+    offsets[fname] = read_offset(in);
+  }
+
+  count = irepconverter.read_long(in);
+  for(unsigned i = 0; i < count; i++)
+  {
+    dstring sname = irepconverter.read_string(in);
+    symbol_entryt &entry = symbol_index[sname];
+    entry.offset = read_offset(in);
+
+    unsigned num_deps = irepconverter.read_long(in);
+    for(unsigned j = 0; j < num_deps; j++)
+      entry.deps.push_back(irepconverter.read_string(in));
   }
 
+  // Every section refers to the one string table
+  ic.strings_in_table = true;
+  in.seekg(strings_offset);
+  count = irepconverter.read_long(in);
+  for(unsigned i = 0; i < count; i++)
+  {
+    unsigned id = irepconverter.read_long(in);
+    if(id >= ic.string_rev_map.size())
+      ic.string_rev_map.resize(id + 1, std::pair<bool, dstring>(false, ""));
+    ic.string_rev_map[id] =
+      std::pair<bool, dstring>(true, irepconverter.read_string(in));
+  }
+
+  index_read = true;
+  return false;
+}
+
+bool goto_binary_readert::read_symbols(
+  contextt &context,
+  goto_functionst &functions)
+{
+  if(read_index())
+    return true;
+
+  memory_streambuft buf(data + symbols_offset, data + size);
+  std::istream in(&buf);
+
+  ic.clear_ireps();
   unsigned count = irepconverter.read_long(in);
 
   for(unsigned i = 0; i < count; i++)
   {
+    // Indexed symbols don't refer to each other's ireps
+    if(!symbol_index.empty())
+      ic.clear_ireps();
+
     irept t;
     symbolconverter.convert(in, t);
     symbolt symbol;
@@ -94,6 +283,9 @@ bool read_bin_goto_object(
     context.add(symbol);
   }
 
+  if(version != 1)
+    return false;
+
   count = irepconverter.read_long(in);
   for(unsigned i = 0; i < count; i++)
   {
@@ -103,7 +295,118 @@ bool read_bin_goto_object(
     goto_functiont &f = functions.function_map[fname];
     convert(t, f.body);
     f.body_available = f.body.instructions.size() > 0;
+    num_loaded++;
   }
 
   return false;
 }
+
+bool goto_binary_readert::read_symbol(const irep_idt &id, symbolt &symbol)
+{
+  auto it = symbol_index.find(id);
+  if(it == symbol_index.end())
+    return false;
+
+  memory_streambuft buf(data + it->second.offset, data + size);
+  std::istream in(&buf);
+
+  ic.clear_ireps();
+
+  irept t;
+  symbolconverter.convert(in, t);
+  symbol.from_irep(t);
+  return true;
+}
+
+void goto_binary_readert::load_function(
+  const irep_idt &id,
+  goto_functionst &functions)
+{
+  auto it = offsets.find(id);
+  if(it == offsets.end())
+    return;
+
+  memory_streambuft buf(data + it->second, data + size);
+  std::istream in(&buf);
+
+  // Bodies don't refer to each other's ireps
+  ic.clear_ireps();
+
+  irept t;
+  gfconverter.convert(in, t);
+  goto_functiont &f = functions.function_map[id];
+  convert(t, f.body);
+  f.body_available = f.body.instructions.size() > 0;
+
+  offsets.erase(it);
+  num_loaded++;
+}
+
+void goto_binary_readert::load_all(goto_functionst &functions)
+{
+  while(!offsets.empty())
+    load_function(offsets.begin()->first, functions);
+}
+
+static void collect_symbols(const expr2tc &expr, std::vector<irep_idt> &dest)
+{
+  if(is_nil_expr(expr))
+    return;
+
+  if(is_symbol2t(expr))
+  {
+    dest.push_back(to_symbol2t(expr).thename);
+    return;
+  }
+
+  expr->foreach_operand(
+    [&dest](const expr2tc &e) { collect_symbols(e, dest); });
+}
+
+static void collect_symbols(const irept &irep, std::vector<irep_idt> &dest)
+{
+  if(irep.id() == "symbol")
+    dest.push_back(irep.identifier());
+
+  forall_irep(it, irep.get_sub())
+    collect_symbols(*it, dest);
+
+  forall_named_irep(it, irep.get_named_sub())
+    collect_symbols(it->second, dest);
+}
+
+bool goto_binary_readert::load_reachable(
+  const irep_idt &id,
+  const contextt &context,
+  goto_functionst &functions)
+{
+  if(offsets.find(id) == offsets.end())
+    return false;
+
+  std::vector<irep_idt> worklist;
+  worklist.push_back(id);
+
+  // Globals may be initialized with the address of a function
+  context.foreach_operand([&worklist](const symbolt &s) {
+    if(!s.type.is_code())
+      collect_symbols(s.value, worklist);
+  });
+
+  while(!worklist.empty())
+  {
+    irep_idt name = worklist.back();
+    worklist.pop_back();
+    if(offsets.find(name) == offsets.end())
+      continue;
+
+    load_function(name, functions);
+
+    for(auto const &insn : functions.function_map[name].body.instructions)
+    {
+      collect_symbols(insn.code, worklist);
+      collect_symbols(insn.guard, worklist);
+    }
+  }
+
+  return true;
+}
@@ -11,9 +11,15 @@ Date: May 2007
 #ifndef READ_BIN_GOTO_OBJECT_H_
 #define READ_BIN_GOTO_OBJECT_H_
 
+#include <cstdint>
+#include <goto-programs/goto_function_serialization.h>
 #include <goto-programs/goto_functions.h>
+#include <map>
+#include <unordered_map>
 #include <util/context.h>
+#include <util/irep_serialization.h>
 #include <util/message.h>
+#include <util/symbol_serialization.h>
 
 bool read_bin_goto_object(
   std::istream &in,
@@ -22,4 +28,97 @@ bool read_bin_goto_object(
   goto_functionst &functions,
   message_handlert &msg_hndlr);
 
+/** A goto binary held in memory, mapped from a file where possible. With
+ *  version 2 binaries, the symbols are read up front and each function body
+ *  is only deserialized when it's asked for, through the index at the end of
+ *  the file. Version 1 binaries are read in full by read_symbols. */
+class goto_binary_readert
+{
+public:
+  goto_binary_readert(message_handlert &_message_handler);
+  ~goto_binary_readert();
+
+  /** Map the file into memory. Returns true on error. */
+  bool open(const std::string &_filename);
+  /** Read the binary from the stream into memory. Returns true on error. */
+  bool open(std::istream &in, const std::string &_filename);
+  /** Read the binary in place; _data must outlive the reader */
+  bool open(const char *_data, std::size_t _size, const std::string &_filename);
+
+  /** Read the header, the index and the string table, once. Returns true
+   *  on error. */
+  bool read_index();
+
+  /** Read the symbols into context, and make an entry without a body in
+   *  functions for each function symbol. Returns true on error. */
+  bool read_symbols(contextt &context, goto_functionst &functions);
+
+  /** Each symbol written with its dependencies, and the symbols it depends
+   *  on; empty if the binary wasn't written that way */
+  struct symbol_entryt
+  {
+    uint64_t offset;
+    std::vector<irep_idt> deps;
+  };
+  typedef std::map<irep_idt, symbol_entryt> symbol_indext;
+  const symbol_indext &get_symbol_index() const
+  {
+    return symbol_index;
+  }
+
+  /** Deserialize one symbol of the symbol index; false if it's not there */
+  bool read_symbol(const irep_idt &id, symbolt &symbol);
+
+  /** Deserialize the body of function id, if it hasn't been already */
+  void load_function(const irep_idt &id, goto_functionst &functions);
+  void load_all(goto_functionst &functions);
+  /** Deserialize the body of function id and of every function that it may
+   *  call, directly or through a pointer, or that is referred to by the
+   *  initial value of a global; false if id isn't in the binary */
+  bool load_reachable(
+    const irep_idt &id,
+    const contextt &context,
+    goto_functionst &functions);
+
+  /** Function bodies in the binary, and how many of them were loaded */
+  std::size_t num_functions() const
+  {
+    return num_loaded + offsets.size();
+  }
+  std::size_t num_loaded_functions() const
+  {
+    return num_loaded;
+  }
+
+protected:
+  message_handlert &message_handler;
+  std::string filename;
+
+  const char *data;
+  std::size_t size;
+  /** Mapped region to unmap, if the file was mapped */
+  void *mapping;
+  /** Holds the binary if it couldn't be mapped */
+  std::string buffer;
+
+  irep_serializationt::ireps_containert ic;
+  irep_serializationt irepconverter;
+  symbol_serializationt symbolconverter;
+  goto_function_serializationt gfconverter;
+
+  /** Offsets of the bodies not loaded yet */
+  std::unordered_map<irep_idt, uint64_t, irep_id_hash> offsets;
+  std::size_t num_loaded;
+
+  symbol_indext symbol_index;
+
+  bool index_read;
+  unsigned version;
+  /** Where the symbols (version 2) or everything (version 1) start */
+  uint64_t symbols_offset;
+
+  uint64_t read_offset(std::istream &in);
+  bool read_header(std::istream &in);
+};
+
 #endif /*READ_BIN_GOTO_OBJECT_H_*/
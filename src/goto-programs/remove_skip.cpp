@@ -78,11 +78,21 @@ bool is_skip(
 /// in the range [begin, end)
 /// \param begin  iterator pointing to first instruction to be considered
 /// \param end  iterator pointing beyond last instruction to be considered
+/// \param removed  if given, the removed instructions are moved here rather
+/// than destroyed
 void remove_skip(
   goto_programt &goto_program,
   goto_programt::targett begin,
-  goto_programt::targett end)
+  goto_programt::targett end,
+  goto_programt::instructionst *removed = nullptr)
 {
+  auto drop = [&goto_program, removed](goto_programt::targett it) {
+    if(removed != nullptr)
+      removed->splice(removed->end(), goto_program.instructions, it);
+    else
+      goto_program.instructions.erase(it);
+  };
+
   // This needs to be a fixed-point, as
   // removing a skip can turn a goto into a skip.
   std::size_t old_size;
@@ -156,7 +166,7 @@ void remove_skip(
     // now delete the skips -- we do so after adjusting the
     // gotos to avoid dangling targets
     for(const auto &new_target : new_targets)
-      goto_program.instructions.erase(new_target.first);
+      drop(new_target.first);
 
     // remove the last skip statement unless it's a target
     goto_program.compute_target_numbers();
@@ -168,7 +178,7 @@ void remove_skip(
         ++begin;
 
       if(is_skip(goto_program, last) && !last->is_target())
-        goto_program.instructions.erase(last);
+        drop(last);
     }
   } while(goto_program.instructions.size() < old_size);
 }
@@ -184,6 +194,19 @@ void remove_skip(goto_programt &goto_program)
   goto_program.update();
 }
 
+/// remove unnecessary skip statements, moving them into removed; the
+/// instructions are left unnumbered
+void remove_skip(
+  goto_programt &goto_program,
+  goto_programt::instructionst &removed)
+{
+  remove_skip(
+    goto_program,
+    goto_program.instructions.begin(),
+    goto_program.instructions.end(),
+    &removed);
+}
+
 /// remove unnecessary skip statements
 void remove_skip(goto_functionst &goto_functions)
 {
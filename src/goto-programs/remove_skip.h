@@ -16,6 +16,9 @@ bool is_skip(
   goto_programt::const_targett,
   bool ignore_labels = false);
 void remove_skip(goto_programt &goto_program);
+void remove_skip(
+  goto_programt &goto_program,
+  goto_programt::instructionst &removed);
 void remove_skip(goto_functionst &goto_functions);
 
 #endif
@@ -9,49 +9,120 @@ Author: CM Wintersteiger
 #include <fstream>
 #include <goto-programs/goto_function_serialization.h>
 #include <goto-programs/write_goto_binary.h>
+#include <set>
+#include <sstream>
 #include <util/irep_serialization.h>
 #include <util/message.h>
 #include <util/symbol_serialization.h>
 
+void write_goto_binary_offset(std::ostream &out, uint64_t offset)
+{
+  write_long(out, offset >> 32);
+  write_long(out, offset & 0xFFFFFFFF);
+}
+
 bool write_goto_binary(
   std::ostream &out,
   const contextt &lcontext,
-  goto_functionst &functions)
+  goto_functionst &functions,
+  const symbol_depst *deps)
 {
-  // header
-  out << "GBF";
-  write_long(out, GOTO_BINARY_VERSION);
-
   irep_serializationt::ireps_containert irepc;
   irep_serializationt irepconverter(irepc);
   symbol_serializationt symbolconverter(irepc);
   goto_function_serializationt gfconverter(irepc);
+  irepc.strings_in_table = true;
 
-  write_long(out, lcontext.size());
-
-  lcontext.foreach_operand([&symbolconverter, &out](const symbolt &s) {
-    symbolconverter.convert(s, out);
-  });
+  // The string table goes first, but what's in it is only known once the
+  // symbols and bodies are serialized, so they're put aside until then.
+  std::ostringstream sections;
 
-  unsigned cnt = 0;
-  forall_goto_functions(it, functions)
-    if(it->second.body_available)
-      cnt++;
+  write_long(sections, lcontext.size());
 
-  write_long(out, cnt);
+  std::vector<std::pair<irep_idt, uint64_t>> symbol_index;
+  lcontext.foreach_operand(
+    [&symbolconverter, &sections, &irepc, &symbol_index, deps](
+      const symbolt &s) {
+      if(deps != nullptr)
+      {
+        irepc.clear_ireps();
+        symbol_index.emplace_back(s.id, sections.tellp());
+      }
+      symbolconverter.convert(s, sections);
+    });
 
+  std::vector<std::pair<irep_idt, uint64_t>> index;
   for(auto &it : functions.function_map)
   {
     if(it.second.body_available)
     {
       it.second.body.compute_location_numbers();
-      write_string(out, it.first.as_string());
-      gfconverter.convert(it.second, out);
+
+      // Each body only refers back to its own ireps, so that it can be read
+      // on its own
+      irepc.clear_ireps();
+      index.emplace_back(it.first, sections.tellp());
+      gfconverter.convert(it.second, sections);
+    }
+  }
+
+  std::ostringstream strings;
+  unsigned cnt = 0;
+  for(bool used : irepc.string_map)
+    if(used)
+      cnt++;
+
+  write_long(strings, cnt);
+  for(unsigned id = 0; id < irepc.string_map.size(); id++)
+  {
+    if(irepc.string_map[id])
+    {
+      write_long(strings, id);
+      write_string(strings, get_string_container().get_string(id));
     }
   }
 
-  //irepconverter.output_map(f);
-  //irepconverter.output_string_map(f);
+  // header
+  out << "GBF";
+  write_long(out, GOTO_BINARY_VERSION);
+
+  uint64_t strings_offset = GOTO_BINARY_HEADER_SIZE;
+  uint64_t symbols_offset = strings_offset + strings.str().size();
+  uint64_t index_offset = symbols_offset + sections.str().size();
+  write_goto_binary_offset(out, index_offset);
+
+  out << strings.str();
+  out << sections.str();
+
+  // index
+  write_goto_binary_offset(out, strings_offset);
+  write_goto_binary_offset(out, symbols_offset);
+  write_long(out, index.size());
+  for(auto const &it : index)
+  {
+    write_string(out, it.first.as_string());
+    write_goto_binary_offset(out, symbols_offset + it.second);
+  }
+
+  write_long(out, symbol_index.size());
+  for(auto const &it : symbol_index)
+  {
+    write_string(out, it.first.as_string());
+    write_goto_binary_offset(out, symbols_offset + it.second);
+
+    // Only what's in this binary is of use to the reader
+    std::set<irep_idt> sym_deps;
+    auto range = deps->equal_range(it.first);
+    for(auto dep = range.first; dep != range.second; dep++)
+      if(
+        dep->second != it.first &&
+        lcontext.find_symbol(dep->second) != nullptr)
+        sym_deps.insert(dep->second);
+
+    write_long(out, sym_deps.size());
+    for(auto const &dep : sym_deps)
+      write_string(out, dep.as_string());
+  }
 
   return false;
 }
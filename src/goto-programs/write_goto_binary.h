@@ -9,15 +9,39 @@ Author: CM Wintersteiger
 #ifndef CPROVER_GOTO_PROGRAMS_WRITE_GOTO_BINARY_H_
 #define CPROVER_GOTO_PROGRAMS_WRITE_GOTO_BINARY_H_
 
-#define GOTO_BINARY_VERSION 1
-
+/** Version 2 binaries are laid out as:
+ *   "GBF", version, offset of the index
+ *   string table: count, then (id, string) for each string
+ *   symbols: count, then each symbol
+ *   function bodies, each referring only to its own ireps and the strings
+ *   index: offsets of the string table and the symbols, count, then
+ *          (name, offset) for each function body, then count, then
+ *          (name, offset, count, dependencies) for each symbol
+ *  so that bodies can be found and read one at a time. Symbols are only
+ *  listed in the index if they were written with their dependencies, in
+ *  which case they can be read one at a time too. Offsets take 8 bytes.
+ */
+#define GOTO_BINARY_VERSION 2
+#define GOTO_BINARY_HEADER_SIZE (3 + 4 + 8)
+
+#include <cstdint>
 #include <goto-programs/goto_functions.h>
+#include <map>
 #include <ostream>
 #include <util/context.h>
 
+/** For each symbol, the symbols its type and value refer to */
+typedef std::multimap<irep_idt, irep_idt> symbol_depst;
+
+void write_goto_binary_offset(std::ostream &out, uint64_t offset);
+
+/** Write a goto binary. If deps is given, each symbol is written so that it
+ *  can be read on its own, and listed in the index with the symbols in
+ *  lcontext that it depends on. */
 bool write_goto_binary(
   std::ostream &out,
   const contextt &lcontext,
-  goto_functionst &functions);
+  goto_functionst &functions,
+  const symbol_depst *deps = nullptr);
 
 #endif
@@ -735,6 +735,22 @@ void goto_symext::symex_va_arg(const expr2tc &lhs, const sideeffect2t &code)
   symex_assign(code_assign2tc(lhs, va_rhs), true);
 }
 
+void goto_symext::bump_intrinsic(
+  const code_function_call2t &func_call,
+  const irep_idt &impl)
+{
+  // We're going to execute a function call, and that's going to mess with
+  // the program counter. Set it back *onto* pointing at this intrinsic, so
+  // symex_function_call calculates the right return address. Misery.
+  cur_state->source.pc--;
+
+  expr2tc newcall = func_call.clone();
+  code_function_call2t &mutable_funccall = to_code_function_call2t(newcall);
+  mutable_funccall.function = symbol2tc(get_empty_type(), impl);
+  // Execute call
+  symex_function_call(newcall);
+}
+
 void goto_symext::intrinsic_memset(
   reachability_treet &art,
   const code_function_call2t &func_call)
@@ -753,18 +769,7 @@ void goto_symext::intrinsic_memset(
   // Define a local function for translating to calling the unwinding C
   // implementation of memset
   auto bump_call = [this, &func_call]() -> void {
-    // We're going to execute a function call, and that's going to mess with
-    // the program counter. Set it back *onto* pointing at this intrinsic, so
-    // symex_function_call calculates the right return address. Misery.
-    cur_state->source.pc--;
-
-    expr2tc newcall = func_call.clone();
-    code_function_call2t &mutable_funccall = to_code_function_call2t(newcall);
-    mutable_funccall.function =
-      symbol2tc(get_empty_type(), "c:@F@__memset_impl");
-    // Execute call
-    symex_function_call(newcall);
-    return;
+    bump_intrinsic(func_call, "c:@F@__memset_impl");
   };
 
   // Skip if the operand is not zero. Because honestly, there's very little
@@ -998,3 +1003,386 @@ void goto_symext::intrinsic_memset(
     bump_call();
   }
 }
+
+/** Longest run of elements that the memcpy, memmove and strlen intrinsics
+ *  build a single expression for. Longer runs go to the C implementation. */
+static const unsigned int max_intrinsic_elems = 4096;
+
+/** A run of array elements that an intrinsic can read or update in one
+ *  expression, starting at the element a pointer points at */
+struct intrinsic_arrayt
+{
+  expr2tc array;
+  type2tc subtype;
+  BigInt elem_size;
+  /** Index of the element pointed at */
+  expr2tc first;
+  /** Number of elements from there to the end of the array, or -1 if that
+   *  isn't constant */
+  BigInt room;
+  /** The array is a field of the object pointed into, not all of it */
+  bool is_field;
+
+  expr2tc index(unsigned int k) const
+  {
+    if(is_constant_int2t(first))
+      return constant_int2tc(
+        pointer_type2(), to_constant_int2t(first).value + k);
+    return add2tc(
+      pointer_type2(), first, constant_int2tc(pointer_type2(), BigInt(k)));
+  }
+};
+
+/** Find the array of scalars that a byte offset into object points at,
+ *  descending into struct fields if the offset is constant */
+static bool
+get_intrinsic_array(expr2tc object, expr2tc offset, intrinsic_arrayt &arr)
+{
+  arr.is_field = false;
+  while(is_struct_type(object) && is_constant_int2t(offset))
+  {
+    const struct_type2t &strct = to_struct_type(object->type);
+    BigInt offs = to_constant_int2t(offset).value;
+    unsigned int i = 0;
+    for(; i < strct.members.size(); i++)
+    {
+      BigInt start = member_offset(object->type, strct.member_names[i]);
+      if(offs >= start && offs < start + type_byte_size(strct.members[i]))
+        break;
+    }
+
+    if(i == strct.members.size())
+      return false;
+
+    BigInt start = member_offset(object->type, strct.member_names[i]);
+    object = member2tc(strct.members[i], object, strct.member_names[i]);
+    offset = constant_int2tc(pointer_type2(), offs - start);
+    arr.is_field = true;
+  }
+
+  if(!is_array_type(object))
+    return false;
+
+  const array_type2t &arrtype = to_array_type(object->type);
+  if(
+    arrtype.size_is_infinite || is_array_type(arrtype.subtype) ||
+    is_struct_type(arrtype.subtype) || is_union_type(arrtype.subtype))
+    return false;
+
+  arr.array = object;
+  arr.subtype = arrtype.subtype;
+  arr.elem_size = type_byte_size(arrtype.subtype);
+  if(arr.elem_size == 0)
+    return false;
+
+  arr.room = -1;
+  if(is_constant_int2t(offset))
+  {
+    const BigInt &offs = to_constant_int2t(offset).value;
+    if(offs < 0 || offs % arr.elem_size != 0)
+      return false;
+
+    BigInt first = offs / arr.elem_size;
+    arr.first = constant_int2tc(pointer_type2(), first);
+    if(is_constant_int2t(arrtype.array_size))
+    {
+      arr.room = to_constant_int2t(arrtype.array_size).value - first;
+      if(arr.room < 0)
+        return false;
+    }
+  }
+  else if(arr.elem_size == 1)
+    arr.first = typecast2tc(pointer_type2(), offset);
+  else
+    return false;
+
+  return true;
+}
+
+/** Whether the n bytes from offset on lie within object */
+static expr2tc
+intrinsic_in_bounds(const expr2tc &object, const expr2tc &offset, expr2tc n)
+{
+  expr2tc size;
+  if(is_array_type(object))
+  {
+    const array_type2t &arrtype = to_array_type(object->type);
+    size = mul2tc(
+      pointer_type2(),
+      typecast2tc(pointer_type2(), arrtype.array_size),
+      constant_int2tc(pointer_type2(), type_byte_size(arrtype.subtype)));
+  }
+  else
+    size = constant_int2tc(pointer_type2(), type_byte_size(object->type));
+
+  expr2tc offs = typecast2tc(pointer_type2(), offset);
+  n = typecast2tc(pointer_type2(), n);
+  return and2tc(
+    lessthanequal2tc(offs, size),
+    lessthanequal2tc(n, sub2tc(pointer_type2(), size, offs)));
+}
+
+void goto_symext::intrinsic_memcpy(
+  reachability_treet &art,
+  const code_function_call2t &func_call,
+  const irep_idt &impl)
+{
+  assert(func_call.operands.size() == 3 && "Wrong memcpy signature");
+  auto &ex_state = art.get_cur_state();
+  expr2tc dst = func_call.operands[0];
+  expr2tc src = func_call.operands[1];
+  expr2tc size = func_call.operands[2];
+
+  // This can be a conditional intrinsic
+  if(ex_state.cur_state->guard.is_false())
+    return;
+
+  // Work out what both pointers point at.
+  std::list<dereference_callbackt::internal_item> dst_items, src_items;
+  internal_deref_items.clear();
+  dereference2tc dst_deref(get_empty_type(), dst);
+  dereference(dst_deref, dereferencet::INTERNAL);
+  dst_items.swap(internal_deref_items);
+
+  dereference2tc src_deref(get_empty_type(), src);
+  dereference(src_deref, dereferencet::INTERNAL);
+  src_items.swap(internal_deref_items);
+
+  cur_state->rename(size);
+  bool const_size = is_constant_int2t(size);
+
+  // For each pair of objects the pointers might point at, build the new value
+  // of the destination object, and what must hold for the copy to stay in
+  // bounds. All elements are copied at once, reading the source before the
+  // destination is written, which is also what memmove needs.
+  struct copyt
+  {
+    expr2tc object;
+    expr2tc value;
+    expr2tc in_bounds;
+    guardt guard;
+  };
+  std::list<copyt> copies;
+
+  try
+  {
+    for(const auto &d : dst_items)
+    {
+      for(const auto &s : src_items)
+      {
+        copyt copy;
+        copy.guard = cur_state->guard;
+        copy.guard.add(d.guard);
+        copy.guard.add(s.guard);
+
+        // Copying a whole object onto another of the same type
+        if(
+          const_size && is_constant_int2t(d.offset) &&
+          to_constant_int2t(d.offset).value == 0 &&
+          is_constant_int2t(s.offset) &&
+          to_constant_int2t(s.offset).value == 0 &&
+          d.object->type == s.object->type &&
+          type_byte_size_default(d.object->type, -1) ==
+            to_constant_int2t(size).value)
+        {
+          copy.object = d.object;
+          copy.value = s.object;
+          copies.push_back(copy);
+          continue;
+        }
+
+        // Otherwise, a run of elements between arrays of the same type
+        intrinsic_arrayt darr, sarr;
+        if(
+          !get_intrinsic_array(d.object, d.offset, darr) ||
+          !get_intrinsic_array(s.object, s.offset, sarr) ||
+          darr.subtype != sarr.subtype)
+        {
+          bump_intrinsic(func_call, impl);
+          return;
+        }
+
+        // How many elements to copy. With a symbolic size, copy as many as
+        // both arrays have room for, each only if it's below the size.
+        BigInt count;
+        if(const_size)
+        {
+          const BigInt &n = to_constant_int2t(size).value;
+          if(
+            n % darr.elem_size != 0 ||
+            (darr.room >= 0 && n / darr.elem_size > darr.room) ||
+            (sarr.room >= 0 && n / darr.elem_size > sarr.room))
+          {
+            bump_intrinsic(func_call, impl);
+            return;
+          }
+          count = n / darr.elem_size;
+        }
+        else
+        {
+          // Copies past the end of a field but within the object are fine in
+          // C, so those can't be bounded by the field.
+          if(
+            darr.elem_size != 1 || darr.is_field || sarr.is_field ||
+            darr.room < 0 || sarr.room < 0)
+          {
+            bump_intrinsic(func_call, impl);
+            return;
+          }
+          count = darr.room < sarr.room ? darr.room : sarr.room;
+        }
+
+        if(count > max_intrinsic_elems)
+        {
+          bump_intrinsic(func_call, impl);
+          return;
+        }
+
+        expr2tc value = darr.array;
+        for(unsigned int k = 0; k < count.to_uint64(); k++)
+        {
+          expr2tc elem = index2tc(sarr.subtype, sarr.array, sarr.index(k));
+          if(!const_size)
+            elem = if2tc(
+              darr.subtype,
+              lessthan2tc(
+                constant_int2tc(pointer_type2(), BigInt(k)),
+                typecast2tc(pointer_type2(), size)),
+              elem,
+              index2tc(darr.subtype, darr.array, darr.index(k)));
+          value = with2tc(darr.array->type, value, darr.index(k), elem);
+        }
+
+        copy.object = darr.array;
+        copy.value = value;
+        if(!const_size || darr.room < 0 || sarr.room < 0)
+          copy.in_bounds = and2tc(
+            intrinsic_in_bounds(d.object, d.offset, size),
+            intrinsic_in_bounds(s.object, s.offset, size));
+        copies.push_back(copy);
+      }
+    }
+  }
+  catch(array_type2t::dyn_sized_array_excp *e)
+  {
+    bump_intrinsic(func_call, impl);
+    return;
+  }
+  catch(array_type2t::inf_sized_array_excp *e)
+  {
+    bump_intrinsic(func_call, impl);
+    return;
+  }
+
+  for(auto &copy : copies)
+  {
+    if(
+      !is_nil_expr(copy.in_bounds) &&
+      !options.get_bool_option("no-bounds-check"))
+    {
+      expr2tc in_bounds = copy.in_bounds;
+      copy.guard.guard_expr(in_bounds);
+      claim(in_bounds, "dereference failure: array bounds violated");
+    }
+
+    symex_assign(code_assign2tc(copy.object, copy.value), false, copy.guard);
+  }
+
+  // Construct assignment to return value
+  expr2tc ret_ref = func_call.ret;
+  if(!is_nil_expr(ret_ref))
+  {
+    dereference(ret_ref, dereferencet::READ);
+    symex_assign(code_assign2tc(ret_ref, dst), false, cur_state->guard);
+  }
+}
+
+void goto_symext::intrinsic_strlen(
+  reachability_treet &art,
+  const code_function_call2t &func_call)
+{
+  assert(func_call.operands.size() == 1 && "Wrong strlen signature");
+  auto &ex_state = art.get_cur_state();
+  expr2tc str = func_call.operands[0];
+  const irep_idt impl = "c:@F@__strlen_impl";
+
+  // This can be a conditional intrinsic
+  if(ex_state.cur_state->guard.is_false())
+    return;
+
+  // Work out what the pointer points at.
+  internal_deref_items.clear();
+  dereference2tc deref(get_empty_type(), str);
+  dereference(deref, dereferencet::INTERNAL);
+
+  expr2tc ret_ref = func_call.ret;
+  type2tc len_type =
+    is_nil_expr(ret_ref) ? pointer_type2() : type2tc(ret_ref->type);
+
+  // For each array of chars pointed at, the length is the index of the first
+  // nul from the pointer on, which has to be within the array: reading on
+  // past the end of a field would still be fine in C, so fields are left to
+  // the C implementation.
+  expr2tc len;
+  std::list<std::pair<guardt, expr2tc>> terminated;
+  try
+  {
+    for(const auto &item : internal_deref_items)
+    {
+      intrinsic_arrayt arr;
+      if(
+        !get_intrinsic_array(item.object, item.offset, arr) ||
+        arr.is_field || arr.elem_size != 1 || !is_bv_type(arr.subtype) ||
+        arr.room <= 0 || arr.room > max_intrinsic_elems)
+      {
+        bump_intrinsic(func_call, impl);
+        return;
+      }
+
+      unsigned int room = arr.room.to_uint64();
+      expr2tc item_len = constant_int2tc(len_type, BigInt(room));
+      expr2tc has_nul = gen_false_expr();
+      for(unsigned int k = room; k-- > 0;)
+      {
+        expr2tc elem = index2tc(arr.subtype, arr.array, arr.index(k));
+        expr2tc is_nul = equality2tc(elem, gen_zero(arr.subtype));
+        item_len = if2tc(
+          len_type, is_nul, constant_int2tc(len_type, BigInt(k)), item_len);
+        has_nul = or2tc(is_nul, has_nul);
+      }
+
+      guardt guard(cur_state->guard);
+      guard.add(item.guard);
+      terminated.emplace_back(guard, has_nul);
+
+      len = is_nil_expr(len) ? item_len
+                             : if2tc(len_type, item.guard, item_len, len);
+    }
+  }
+  catch(array_type2t::dyn_sized_array_excp *e)
+  {
+    bump_intrinsic(func_call, impl);
+    return;
+  }
+  catch(array_type2t::inf_sized_array_excp *e)
+  {
+    bump_intrinsic(func_call, impl);
+    return;
+  }
+
+  if(!options.get_bool_option("no-bounds-check"))
+  {
+    for(auto &t : terminated)
+    {
+      t.first.guard_expr(t.second);
+      claim(t.second, "dereference failure: array bounds violated");
+    }
+  }
+
+  // Construct assignment to return value
+  if(!is_nil_expr(ret_ref) && !is_nil_expr(len))
+  {
+    dereference(ret_ref, dereferencet::READ);
+    symex_assign(code_assign2tc(ret_ref, len), false, cur_state->guard);
+  }
+}
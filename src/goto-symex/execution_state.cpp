@@ -98,8 +98,7 @@ execution_statet::execution_statet(
   thread_last_reads.emplace_back();
   thread_last_writes.emplace_back();
   // One thread with one dependancy relation.
-  dependancy_chain.emplace_back();
-  dependancy_chain.back().push_back(0);
+  dependancy_chain.write().emplace_back(1, 0);
   mpor_says_no = false;
 
   cswitch_forced = false;
@@ -179,30 +178,10 @@ execution_statet &execution_statet::operator=(const execution_statet &ex)
   mpor_says_no = ex.mpor_says_no;
   cswitch_forced = ex.cswitch_forced;
 
-  // Vastly irritatingly, we have to iterate through existing level2t objects
-  // updating their ex_state references. There isn't an elegant way of updating
-  // them, it seems, while keeping the symex stuff ignorant of ex_state.
-  // Oooooo, so this is where auto types would be useful...
-  for(auto &it : threads_state)
-  {
-    for(goto_symex_statet::call_stackt::iterator it2 = it.call_stack.begin();
-        it2 != it.call_stack.end();
-        it2++)
-    {
-      for(auto &it3 : it2->goto_state_map)
-      {
-        for(goto_symex_statet::goto_state_listt::iterator it4 =
-              it3.second.begin();
-            it4 != it3.second.begin();
-            it4++)
-        {
-          ex_state_level2t &l2 = dynamic_cast<ex_state_level2t &>(it4->level2);
-          l2.owner = this;
-        }
-      }
-    }
-  }
-
+  // The level2 copies in the goto_statets of the call stacks keep referring to
+  // the ex_state they were made in: the call stacks are shared with that
+  // ex_state until one of them writes to its own, so they can't be updated
+  // here. Only the global level2 is ours alone.
   state_level2->owner = this;
 
   return *this;
@@ -442,8 +421,8 @@ void execution_statet::update_after_switch_point()
 
   // MPOR records the variables accessed in last transition taken; we're
   // starting a new transition, so for the current thread, clear records.
-  thread_last_reads[active_thread].clear();
-  thread_last_writes[active_thread].clear();
+  thread_last_reads[active_thread] = cowt<std::set<expr2tc>>();
+  thread_last_writes[active_thread] = cowt<std::set<expr2tc>>();
 
   cswitch_forced = false;
 
@@ -473,7 +452,7 @@ void execution_statet::preserve_last_paths()
   // we switched on a GOTO instruction, we may have forked. In that case we
   // need to find the branch that was generated there.
 
-  auto &pp = preserved_paths[last_active_thread];
+  auto &pp = preserved_paths[last_active_thread].write();
   auto &ls = threads_state[last_active_thread];
   assert(pp.size() == 0 && "Unmerged preserved paths in ex_state");
   assert(last_insn != nullptr && "Last insn unset in preserve_last_paths");
@@ -588,7 +567,10 @@ void execution_statet::restore_last_paths()
   // Given that we're discarding a lot of data here this could all be more
   // efficient, but it's what we've got.
 
-  auto &list = preserved_paths[active_thread];
+  const auto &list = *preserved_paths[active_thread];
+  if(list.empty())
+    return;
+
   for(auto const &p : list)
   {
     const auto &loc = p.first;
@@ -608,7 +590,7 @@ void execution_statet::restore_last_paths()
     // And that is it!
   }
 
-  list.clear();
+  preserved_paths[active_thread] = cowt<preserved_pathst>();
 }
 
 bool execution_statet::is_cur_state_guard_false()
@@ -729,18 +711,17 @@ unsigned int execution_statet::add_thread(const goto_programt *prog)
   // Unfortunately as each thread has a depenancy relation with every other
   // thread we have to do a lot of work to initialize a new one. And initially
   // all relations are '0', no transitions yet.
-  for(auto &it : dependancy_chain)
+  auto &chain = dependancy_chain.write();
+  for(auto &it : chain)
   {
     it.push_back(0);
   }
   // And the new threads dependancies,
-  dependancy_chain.emplace_back();
-  for(unsigned int i = 0; i < dependancy_chain.size(); i++)
-    dependancy_chain.back().push_back(0);
+  chain.emplace_back(chain.size() + 1, 0);
 
   // While we've recorded the new thread as starting in the designated program,
   // it might not run immediately, thus must have it's path preserved:
-  preserved_paths[thread_nr].push_back(std::make_pair(
+  preserved_paths[thread_nr].write().push_back(std::make_pair(
     prog->instructions.begin(), goto_statet(threads_state[thread_nr])));
 
   return threads_state.size() - 1; // thread ID, zero based
@@ -759,9 +740,9 @@ void execution_statet::analyze_assign(const expr2tc &code)
   if(global_reads.size() > 0 || global_writes.size() > 0)
   {
     // Record read/written data
-    thread_last_reads[active_thread].insert(
+    thread_last_reads[active_thread].write().insert(
       global_reads.begin(), global_reads.end());
-    thread_last_writes[active_thread].insert(
+    thread_last_writes[active_thread].write().insert(
       global_writes.begin(), global_writes.end());
   }
 }
@@ -774,7 +755,7 @@ void execution_statet::analyze_read(const expr2tc &code)
   if(global_reads.size() > 0)
   {
     // Record read/written data
-    thread_last_reads[active_thread].insert(
+    thread_last_reads[active_thread].write().insert(
       global_reads.begin(), global_reads.end());
   }
 }
@@ -886,25 +867,30 @@ bool execution_statet::check_mpor_dependancy(unsigned int j, unsigned int l)
   // transitions (j) reads or writes; and that the previous transitions reads
   // don't intersect with this transitions write(s).
 
+  const std::set<expr2tc> &reads_j = *thread_last_reads[j];
+  const std::set<expr2tc> &writes_j = *thread_last_writes[j];
+  const std::set<expr2tc> &reads_l = *thread_last_reads[l];
+  const std::set<expr2tc> &writes_l = *thread_last_writes[l];
+
   // Double write intersection
-  for(std::set<expr2tc>::const_iterator it = thread_last_writes[j].begin();
-      it != thread_last_writes[j].end();
+  for(std::set<expr2tc>::const_iterator it = writes_j.begin();
+      it != writes_j.end();
       it++)
-    if(thread_last_writes[l].find(*it) != thread_last_writes[l].end())
+    if(writes_l.find(*it) != writes_l.end())
       return true;
 
   // This read what that wrote intersection
-  for(std::set<expr2tc>::const_iterator it = thread_last_reads[j].begin();
-      it != thread_last_reads[j].end();
+  for(std::set<expr2tc>::const_iterator it = reads_j.begin();
+      it != reads_j.end();
       it++)
-    if(thread_last_writes[l].find(*it) != thread_last_writes[l].end())
+    if(writes_l.find(*it) != writes_l.end())
       return true;
 
   // We wrote what that reads intersection
-  for(std::set<expr2tc>::const_iterator it = thread_last_writes[j].begin();
-      it != thread_last_writes[j].end();
+  for(std::set<expr2tc>::const_iterator it = writes_j.begin();
+      it != writes_j.end();
       it++)
-    if(thread_last_reads[l].find(*it) != thread_last_reads[l].end())
+    if(reads_l.find(*it) != reads_l.end())
       return true;
 
   // No check for read-read intersection, it doesn't affect anything
@@ -926,7 +912,8 @@ void execution_statet::calculate_mpor_constraints()
   //  dependancy_chain contains the state from the previous transition taken;
   //  here we update it to reflect the latest transition, and make a decision
   //  about progress later.
-  std::vector<std::vector<int>> new_dep_chain = dependancy_chain;
+  const std::vector<std::vector<int>> &old_dep_chain = *dependancy_chain;
+  std::vector<std::vector<int>> new_dep_chain = old_dep_chain;
 
   // Start new dependancy chain for this thread. Default to there being no
   // relation.
@@ -943,7 +930,7 @@ void execution_statet::calculate_mpor_constraints()
     if(j == active_thread)
       continue;
 
-    if(dependancy_chain[j][active_thread] == 0)
+    if(old_dep_chain[j][active_thread] == 0)
     {
       // This thread hasn't been run; continue not having been run.
       new_dep_chain[j][active_thread] = 0;
@@ -959,7 +946,7 @@ void execution_statet::calculate_mpor_constraints()
 
       for(unsigned int l = 0; l < new_dep_chain.size(); l++)
       {
-        if(dependancy_chain[j][l] != 1)
+        if(old_dep_chain[j][l] != 1)
           continue; // No dependancy relation here
 
         // Now check for variable dependancy.
@@ -999,7 +986,7 @@ void execution_statet::calculate_mpor_constraints()
     bool dep_exists = false;
     for(unsigned int l = 0; l < active_thread; l++)
     {
-      if(dependancy_chain[j][l] == 1)
+      if(old_dep_chain[j][l] == 1)
         dep_exists = true;
     }
 
@@ -1012,7 +999,8 @@ void execution_statet::calculate_mpor_constraints()
 
   mpor_says_no = !can_run;
 
-  dependancy_chain = new_dep_chain;
+  dependancy_chain =
+    cowt<std::vector<std::vector<int>>>(std::move(new_dep_chain));
 }
 
 bool execution_statet::has_cswitch_point_occured() const
@@ -1023,8 +1011,8 @@ bool execution_statet::has_cswitch_point_occured() const
     return true;
 
   if(
-    thread_last_reads[active_thread].size() != 0 ||
-    thread_last_writes[active_thread].size() != 0)
+    !thread_last_reads[active_thread]->empty() ||
+    !thread_last_writes[active_thread]->empty())
     return true;
 
   return false;
@@ -1073,6 +1061,51 @@ crypto_hash execution_statet::update_hash_for_assignment(const expr2tc &rhs)
   return h;
 }
 
+fast_hash execution_statet::generate_fast_hash() const
+{
+  auto l2 = std::dynamic_pointer_cast<state_hashing_level2t>(state_level2);
+  assert(l2 != nullptr && l2->fast);
+
+  fast_hash h;
+  h.ingest(l2->fast_l2_hash.hash[0]);
+  h.ingest(l2->fast_l2_hash.hash[1]);
+
+  // Thread order matters here, unlike for the variables
+  for(const auto &it : threads_state)
+    h.ingest(it.source.pc->location_number);
+
+  h.fin();
+  return h;
+}
+
+/** Feed the structure of expr into h. crc() is cached in each node, so this
+ *  costs a visit per node rather than a walk over every field. */
+static void fast_hash_expr(const expr2tc &expr, fast_hash &h)
+{
+  if(is_nil_expr(expr))
+  {
+    h.ingest(0);
+    return;
+  }
+
+  h.ingest(((uint64_t)expr->expr_id << 32) ^ expr->get_num_sub_exprs());
+  h.ingest(expr.crc());
+  expr->foreach_operand(
+    [&h](const expr2tc &e) { fast_hash_expr(e, h); });
+}
+
+fast_hash execution_statet::fast_hash_for_assignment(
+  const irep_idt &name,
+  const expr2tc &rhs)
+{
+  fast_hash h;
+  const std::string &str = name.as_string();
+  h.ingest(str.c_str(), str.size());
+  fast_hash_expr(rhs, h);
+  h.fin();
+  return h;
+}
+
 void execution_statet::print_stack_traces(unsigned int indent) const
 {
   std::vector<goto_symex_statet>::const_iterator it;
@@ -1246,8 +1279,9 @@ void schedule_execution_statet::claim(
 }
 
 execution_statet::state_hashing_level2t::state_hashing_level2t(
-  execution_statet &ref)
-  : ex_state_level2t(ref)
+  execution_statet &ref,
+  bool fast)
+  : ex_state_level2t(ref), fast(fast)
 {
 }
 
@@ -1268,7 +1302,20 @@ void execution_statet::state_hashing_level2t::make_assignment(
   renaming::level2t::make_assignment(lhs_sym, const_value, assigned_value);
 
   // If there's no body to the assignment, don't hash.
-  if(!is_nil_expr(assigned_value))
+  if(!is_nil_expr(assigned_value) && fast)
+  {
+    // XOR out the variable's previous value, XOR in the new one
+    const irep_idt &orig_name = to_symbol2t(lhs_sym).thename;
+    fast_hash hash = fast_hash_for_assignment(orig_name, assigned_value);
+    auto it = fast_hashes.emplace(orig_name, hash);
+    if(!it.second)
+    {
+      fast_l2_hash ^= it.first->second;
+      it.first->second = hash;
+    }
+    fast_l2_hash ^= hash;
+  }
+  else if(!is_nil_expr(assigned_value))
   {
     // XXX - consider whether to use l1 names instead. Recursion, reentrancy.
     crypto_hash hash = owner->update_hash_for_assignment(assigned_value);
@@ -20,6 +20,9 @@
 #include <list>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <util/cow.h>
+#include <util/fast_hash.h>
 #include <util/irep2.h>
 #include <util/message.h>
 #include <util/std_expr.h>
@@ -125,7 +128,7 @@ public:
   class state_hashing_level2t : public ex_state_level2t
   {
   public:
-    state_hashing_level2t(execution_statet &ref);
+    state_hashing_level2t(execution_statet &ref, bool fast);
     ~state_hashing_level2t() override = default;
     std::shared_ptr<renaming::level2t> clone() const override;
     void make_assignment(
@@ -135,6 +138,15 @@ public:
     crypto_hash generate_l2_state_hash() const;
     typedef std::map<irep_idt, crypto_hash> current_state_hashest;
     current_state_hashest current_hashes;
+
+    /** Hash with fast_hash, keeping the digest of the l2 state up to date
+     *  on each assignment (--fast-state-hashing) */
+    bool fast;
+    typedef std::unordered_map<irep_idt, fast_hash, irep_id_hash>
+      fast_state_hashest;
+    fast_state_hashest fast_hashes;
+    /** XOR of everything in fast_hashes */
+    fast_hash fast_l2_hash;
   };
 
   // Macros
@@ -485,6 +497,24 @@ public:
    */
   crypto_hash update_hash_for_assignment(const expr2tc &rhs);
 
+  /**
+   *  Generate fast_hash of entire execution state.
+   *  Like generate_hash, but combines the incrementally maintained digest of
+   *  the l2 state with each thread's program counter, without building any
+   *  strings. Requires --fast-state-hashing.
+   *  @return Hash of entire current execution state.
+   */
+  fast_hash generate_fast_hash() const;
+
+  /**
+   *  Generate fast_hash of a variable having a particular value.
+   *  @param name Name of the assigned variable.
+   *  @param rhs Value assigned to it.
+   *  @return Hash of the assignment.
+   */
+  static fast_hash
+  fast_hash_for_assignment(const irep_idt &name, const expr2tc &rhs);
+
   /**
    *  Print stack trace of each thread to stdout.
    *  Uses the passed in namespace; also uses whatever level of indentation
@@ -518,13 +548,15 @@ public:
   /** Stack of thread states. The index into this vector is the thread ID of
    *  the goto_symex_statet at that location */
   std::vector<goto_symex_statet> threads_state;
+  typedef std::list<std::pair<goto_programt::const_targett, goto_statet>>
+    preserved_pathst;
   /** Preserved paths. After switching out of a thread, only the paths active
    *  at the time the switch occurred are allowed to live, and are stored
    *  here. Format is: for each thread, a list of paths, which are made up
    *  of an insn number where the path merges and it's goto_statet when we
-   *  switched away. Preserved paths can only be in the top() frame.  */
-  std::vector<std::list<std::pair<goto_programt::const_targett, goto_statet>>>
-    preserved_paths;
+   *  switched away. Preserved paths can only be in the top() frame. Each
+   *  thread's list is shared with clones of this ex_state until written. */
+  std::vector<cowt<preserved_pathst>> preserved_paths;
   /** Atomic section count. Every time an atomic begin is executed, the
    *  atomic_number corresponding to the thread is incremented, allowing nested
    *  atomic begins and ends. A nonzero atomic number for a thread means that
@@ -597,14 +629,15 @@ protected:
   /** For each thread, a set of symbols that were read by the thread in the
    *  last transition (run). Renamed to level1, as that identifies each piece of
    *  data that could have storage in C. */
-  std::vector<std::set<expr2tc>> thread_last_reads;
+  std::vector<cowt<std::set<expr2tc>>> thread_last_reads;
   /** For each thread, a set of symbols that were written by the thread in the
    *  last transition (run). Renamed to level1, as that identifies each piece of
    *  data that could have storage in C. */
-  std::vector<std::set<expr2tc>> thread_last_writes;
+  std::vector<cowt<std::set<expr2tc>>> thread_last_writes;
   /** Dependancy chain for POR calculations. In mpor paper, DCij elements map
-   *  to dependancy_chain[i][j] here. */
-  std::vector<std::vector<int>> dependancy_chain;
+   *  to dependancy_chain[i][j] here. Replaced wholesale after each transition,
+   *  so clones share it rather than copying the matrix. */
+  cowt<std::vector<std::vector<int>>> dependancy_chain;
   /** MPOR scheduling outcome. If we've just taken a transition that MPOR
    *  rejects, this becomes true. For various reasons, we can't tell whether or
    *  not MPOR rejects a transition in advance. */
@@ -657,8 +690,8 @@ public:
         std::move(_target),
         context,
         options.get_bool_option("state-hashing")
-          ? std::shared_ptr<state_hashing_level2t>(
-              new state_hashing_level2t(*this))
+          ? std::shared_ptr<state_hashing_level2t>(new state_hashing_level2t(
+              *this, options.get_bool_option("fast-state-hashing")))
           : std::shared_ptr<ex_state_level2t>(new ex_state_level2t(*this)),
         options,
         _message_handler){};
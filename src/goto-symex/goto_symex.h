@@ -13,8 +13,10 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <goto-symex/goto_symex_state.h>
 #include <goto-symex/symex_target.h>
 #include <map>
+#include <memory>
 #include <pointer-analysis/dereference.h>
 #include <stack>
+#include <unordered_map>
 #include <util/i2string.h>
 #include <util/irep2.h>
 #include <util/options.h>
@@ -170,6 +172,21 @@ protected:
    */
   void dereference(expr2tc &expr, dereferencet::modet mode);
 
+  /** What dereferencing a level 1 expression gave, and what that depended
+   *  on: the value sets and liveness queries made, with their answers, and
+   *  the dereference failure claims it generated. */
+  struct deref_templatet
+  {
+    dereferencet::modet mode;
+    expr2tc result;
+    std::vector<std::pair<expr2tc, value_setst::valuest>> value_sets;
+    std::vector<std::pair<expr2tc, bool>> live_variables;
+    std::vector<std::pair<expr2tc, std::string>> claims;
+  };
+
+  typedef std::unordered_map<expr2tc, deref_templatet, irep2_hash>
+    deref_templatest;
+
   // symex
 
   /**
@@ -433,6 +450,24 @@ protected:
   void intrinsic_memset(
     reachability_treet &art,
     const code_function_call2t &func_call);
+  /** memcpy and memmove as one assignment to each object that the
+   *  destination might point at.
+   *  @param impl C implementation to call instead when that can't be done. */
+  void intrinsic_memcpy(
+    reachability_treet &art,
+    const code_function_call2t &func_call,
+    const irep_idt &impl);
+  /** strlen as one expression over each array the string might be in. */
+  void intrinsic_strlen(
+    reachability_treet &art,
+    const code_function_call2t &func_call);
+  /** Call the C implementation of an intrinsic instead of it, for when the
+   *  intrinsic can't handle its arguments.
+   *  @param func_call Call to the intrinsic.
+   *  @param impl Name of the function to call instead. */
+  void bump_intrinsic(
+    const code_function_call2t &func_call,
+    const irep_idt &impl);
 
   /** Walk back up stack frame looking for exception handler. */
   bool symex_throw();
@@ -826,6 +861,20 @@ protected:
   /** Flag as to whether we're doing a k-induction inductive step.
    *  Corresponds to the option --inductive-step */
   bool inductive_step;
+  /** Flag as to whether dereferences are reused from deref_templates.
+   *  Corresponds to the option --symex-templates */
+  bool symex_templates;
+  /** Dereferenced forms of the expressions met so far, by their level 1
+   *  form. The statements of an unrolled loop body are met again on every
+   *  iteration with the same level 1 names; as long as the pointers in them
+   *  still point at the same objects, the dereferenced form is the same and
+   *  only its claims need generating again. Shared between states, as the
+   *  recorded queries are checked against the state reusing an entry. */
+  std::shared_ptr<deref_templatest> deref_templates;
+  /** Dereferences of single pointers, to reuse while the pointer's value set
+   *  stays the same; nullptr with --no-deref-memo. Shared between states, as
+   *  value set versions are unique across them. */
+  std::shared_ptr<dereferencet::memot> deref_memo;
   /** Set of dereference state records; this field is used as a mailbox between
    *  the dereference code and the caller, who will inspect the contents after
    *  a call to dereference (in INTERNAL mode) completes. */
@@ -840,14 +889,25 @@ public:
   symex_dereference_statet(
     goto_symext &_goto_symex,
     goto_symext::statet &_state)
-    : goto_symex(_goto_symex), state(_state)
+    : record(nullptr), goto_symex(_goto_symex), state(_state)
   {
   }
 
+  /** Whether the queries recorded in t get the same answers in this state,
+   *  so that its result can be reused. */
+  bool same_answers(const goto_symext::deref_templatet &t);
+
+  /** Where to record the queries made and claims generated, if anywhere */
+  goto_symext::deref_templatet *record;
+
+  unsigned long get_value_set_version() override;
+
 protected:
   goto_symext &goto_symex;
   goto_symext::statet &state;
 
+  bool check_live_variable(const expr2tc &sym);
+
   void dereference_failure(
     const std::string &property,
     const std::string &msg,
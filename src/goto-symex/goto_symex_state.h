@@ -21,6 +21,7 @@
 #include <stack>
 #include <string>
 #include <unordered_set>
+#include <util/cow.h>
 #include <util/crypto_hash.h>
 #include <util/guard.h>
 #include <util/i2string.h>
@@ -79,7 +80,6 @@ public:
   typedef std::list<goto_statet> goto_state_listt;
   typedef std::map<goto_programt::const_targett, goto_state_listt>
     goto_state_mapt;
-  typedef std::vector<framet> call_stackt;
   typedef std::unordered_set<
     renaming::level2t::name_record,
     renaming::level2t::name_rec_hash>
@@ -228,6 +228,101 @@ public:
     }
   };
 
+  /**
+   *  Stack of framet's, shared between the clones of a state until one of
+   *  them modifies it. Cloning an execution_statet copies the call stacks of
+   *  all its threads, but usually only one of those threads runs afterwards;
+   *  the others keep pointing at the same frames. Const accessors never
+   *  copy, the others give the stack a copy of its own first.
+   */
+  class call_stackt
+  {
+  public:
+    typedef std::vector<framet> framest;
+    typedef framest::iterator iterator;
+    typedef framest::const_iterator const_iterator;
+    typedef framest::reverse_iterator reverse_iterator;
+    typedef framest::const_reverse_iterator const_reverse_iterator;
+
+    bool empty() const
+    {
+      return frames->empty();
+    }
+
+    std::size_t size() const
+    {
+      return frames->size();
+    }
+
+    const framet &operator[](std::size_t i) const
+    {
+      return (*frames)[i];
+    }
+
+    framet &back()
+    {
+      return frames.write().back();
+    }
+
+    const framet &back() const
+    {
+      return frames->back();
+    }
+
+    iterator begin()
+    {
+      return frames.write().begin();
+    }
+
+    iterator end()
+    {
+      return frames.write().end();
+    }
+
+    const_iterator begin() const
+    {
+      return frames->begin();
+    }
+
+    const_iterator end() const
+    {
+      return frames->end();
+    }
+
+    reverse_iterator rbegin()
+    {
+      return frames.write().rbegin();
+    }
+
+    reverse_iterator rend()
+    {
+      return frames.write().rend();
+    }
+
+    const_reverse_iterator rbegin() const
+    {
+      return frames->rbegin();
+    }
+
+    const_reverse_iterator rend() const
+    {
+      return frames->rend();
+    }
+
+    void emplace_back(unsigned int thread_id)
+    {
+      frames.write().emplace_back(thread_id);
+    }
+
+    void pop_back()
+    {
+      frames.write().pop_back();
+    }
+
+  private:
+    cowt<framest> frames;
+  };
+
   // Exception Handling
 
   class exceptiont
@@ -324,9 +419,10 @@ public:
   /**
    *  Return stack frame of previous function call.
    */
-  inline const framet &previous_frame()
+  inline const framet &previous_frame() const
   {
-    return *(--(--call_stack.end()));
+    assert(call_stack.size() > 1);
+    return call_stack[call_stack.size() - 2];
   }
 
   // Methods
@@ -447,7 +543,7 @@ public:
    *  becomes the l1 renaming number in renamed variables. Used to be a counter
    *  for each function invocation, but the existance of decl insns makes l1
    *  re-naming out of step with function invocations. */
-  std::map<irep_idt, unsigned> variable_instance_nums;
+  cowt<std::map<irep_idt, unsigned>> variable_instance_nums;
   /** Record of how many loop unwinds we've performed. For each target in the
    *  program that contains a loop, record how many times we've unwound round
    *  it. */
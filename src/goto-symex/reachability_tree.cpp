@@ -24,6 +24,9 @@ Author: Lucas Cordeiro, lcc08r@ecs.soton.ac.uk
 #include <util/message.h>
 #include <util/std_expr.h>
 
+unsigned long reachability_treet::clone_count = 0;
+fine_timet reachability_treet::clone_time = 0;
+
 reachability_treet::reachability_treet(
   goto_functionst &goto_functions,
   const namespacet &ns,
@@ -47,6 +50,7 @@ reachability_treet::reachability_treet(
   CS_bound = atoi(options.get_option("context-bound").c_str());
   TS_slice = atoi(options.get_option("time-slice").c_str());
   state_hashing = options.get_bool_option("state-hashing");
+  fast_state_hashing = options.get_bool_option("fast-state-hashing");
   directed_interleavings = options.get_bool_option("direct-interleavings");
   interactive_ileaves = options.get_bool_option("interactive-ileaves");
   round_robin = options.get_bool_option("round-robin");
@@ -57,6 +61,16 @@ reachability_treet::reachability_treet(
   else
     por = true;
 
+  dfs_claims = nullptr;
+  dfs_num_claims = 0;
+  dfs_split_depth = 0;
+  dfs_worker = 0;
+  dfs_num_workers = 1;
+  dfs_next_subtree = 0;
+  formula_claimed = true;
+  resume_unwinding = false;
+  unwinding_cut = false;
+
   target_template = std::move(target);
 }
 
@@ -67,6 +81,39 @@ void reachability_treet::setup_for_new_explore()
   execution_states.clear();
 
   has_complete_formula = false;
+  dfs_next_subtree = 0;
+  formula_claimed = true;
+
+  // A checkpoint is kept across explorations only if the encoding is too,
+  // i.e. with --incremental-solver. The inductive step turns assertions into
+  // assumptions depending on the bound, so nothing it did can be reused.
+  resume_unwinding = options.get_bool_option("incremental-solver") &&
+                     !options.get_bool_option("inductive-step") &&
+                     !options.get_bool_option("smt-during-symex") && !schedule;
+  unwinding_cut = false;
+
+  if(resume_unwinding && unwind_checkpoint)
+  {
+    std::shared_ptr<execution_statet> resumed = std::move(unwind_checkpoint);
+    unwind_checkpoint = nullptr;
+
+    // No bound may have shrunk, or symex would have cut a loop before the
+    // checkpoint. Zero stands for no bound.
+    BigInt unwind(options.get_option("unwind").c_str());
+    if(
+      unwind == 0 ||
+      (resumed->max_unwind != 0 && unwind >= resumed->max_unwind))
+    {
+      resumed->max_unwind = unwind;
+      execution_states.push_back(resumed);
+      cur_state_it = execution_states.begin();
+      schedule_target = nullptr;
+      std::cout << "Resuming symex from the last unwinding checkpoint"
+                << std::endl;
+      return;
+    }
+  }
+  unwind_checkpoint = nullptr;
 
   execution_statet *s;
   if(schedule)
@@ -103,6 +150,24 @@ void reachability_treet::setup_for_new_explore()
   targ->push_ctx(); // Start with a depth of 1.
 }
 
+void reachability_treet::checkpoint_unwinding()
+{
+  if(!resume_unwinding || unwinding_cut)
+    return;
+
+  // The other states on the stack would have to be saved along with it
+  if(execution_states.size() != 1 || get_cur_state().threads_state.size() != 1)
+    return;
+
+  unwind_checkpoint = get_cur_state().clone();
+}
+
+void reachability_treet::print_clone_stats(std::ostream &out)
+{
+  out << "Execution state clones: " << clone_count << " in "
+      << time2string(clone_time) << "s" << std::endl;
+}
+
 execution_statet &reachability_treet::get_cur_state()
 {
   return **cur_state_it;
@@ -127,6 +192,9 @@ bool reachability_treet::check_for_hash_collision() const
 {
   const execution_statet &ex_state = get_cur_state();
 
+  if(fast_state_hashing)
+    return fast_hit_hashes.contains(ex_state.generate_fast_hash());
+
   crypto_hash hash;
   hash = ex_state.generate_hash();
   if(hit_hashes.find(hash) != hit_hashes.end())
@@ -145,6 +213,12 @@ void reachability_treet::update_hash_collision_set()
 {
   execution_statet &ex_state = get_cur_state();
 
+  if(fast_state_hashing)
+  {
+    fast_hit_hashes.insert(ex_state.generate_fast_hash());
+    return;
+  }
+
   crypto_hash hash;
   hash = ex_state.generate_hash();
   hit_hashes.insert(hash);
@@ -156,7 +230,10 @@ void reachability_treet::create_next_state()
 
   if(next_thread_id != ex_state.threads_state.size())
   {
+    fine_timet clone_start = current_time();
     auto new_state = ex_state.clone();
+    clone_time += current_time() - clone_start;
+    clone_count++;
     execution_states.push_back(new_state);
 
     //begin - H.Savino
@@ -233,6 +310,12 @@ reachability_treet::decide_ileave_direction(execution_statet &ex_state)
     if(!ex_state.dfs_explore_thread(tid))
       continue;
 
+    // Subtrees claimed by another process of a shared DFS are left to it
+    if(
+      dfs_claims != nullptr && execution_states.size() == dfs_split_depth &&
+      !claim_dfs_subtree())
+      continue;
+
 #if 0
     //apply static partial-order reduction
     if (por && !ex_state.is_thread_mpor_schedulable(tid))
@@ -737,9 +820,39 @@ reachability_treet::get_next_formula()
 
   has_complete_formula = false;
 
+  // With a shared DFS, an interleaving that ends above the split depth is a
+  // subtree of its own
+  formula_claimed = dfs_claims == nullptr ||
+                    execution_states.size() > dfs_split_depth ||
+                    claim_dfs_subtree();
+
   return get_cur_state().get_symex_result();
 }
 
+void reachability_treet::share_dfs(
+  std::atomic<bool> *claims,
+  unsigned int num_claims,
+  unsigned int split_depth,
+  unsigned int worker,
+  unsigned int num_workers)
+{
+  dfs_claims = claims;
+  dfs_num_claims = num_claims;
+  dfs_split_depth = split_depth;
+  dfs_worker = worker;
+  dfs_num_workers = num_workers;
+}
+
+bool reachability_treet::claim_dfs_subtree()
+{
+  unsigned int subtree = dfs_next_subtree++;
+  if(subtree < dfs_num_claims)
+    return !dfs_claims[subtree].exchange(true);
+
+  // Out of table entries, split the rest statically
+  return subtree % dfs_num_workers == dfs_worker;
+}
+
 bool reachability_treet::setup_next_formula()
 {
   return reset_to_unexplored_state();
@@ -9,6 +9,7 @@ Author: Lucas Cordeiro, lcc08r@ecs.soton.ac.uk
 #ifndef REACHABILITY_TREE_H_
 #define REACHABILITY_TREE_H_
 
+#include <atomic>
 #include <deque>
 #include <goto-programs/goto_program.h>
 #include <goto-symex/execution_state.h>
@@ -19,8 +20,10 @@ Author: Lucas Cordeiro, lcc08r@ecs.soton.ac.uk
 #include <unordered_map>
 #include <unordered_set>
 #include <util/crypto_hash.h>
+#include <util/fast_hash.h>
 #include <util/message.h>
 #include <util/options.h>
+#include <util/time_stopping.h>
 
 /**
  *  Class to explore states reachable through threading.
@@ -90,6 +93,20 @@ public:
    *  exploration using this object has been completed. */
   void setup_for_new_explore();
 
+  /** Keep a copy of the current state to resume later explorations from.
+   *  Called by symex when a loop is about to reach its unwinding bound: as
+   *  long as no loop or recursion has been cut yet, everything symex did up
+   *  to here is the same under any higher bound, so with --incremental-solver
+   *  the next exploration starts from this copy rather than from main. */
+  void checkpoint_unwinding();
+
+  /** Record that symex cut a loop or recursion at its unwinding bound; no
+   *  later state of this exploration can be a checkpoint. */
+  void record_unwinding_cut()
+  {
+    unwinding_cut = true;
+  }
+
   /**
    *  Return current execution_statet being explored / symex'd.
    *  @return Current execution_statet being explored.
@@ -250,6 +267,35 @@ public:
    */
   bool setup_next_formula();
 
+  /**
+   *  Share the exploration with other processes (--parallel-dfs).
+   *  Every process explores the same tree down to split_depth context switch
+   *  points. Below that, each subtree, and each interleaving that ends above
+   *  it, is only explored by the process that claims its entry first.
+   *  State hashing must be off, so that every process numbers the subtrees
+   *  the same way.
+   *  @param claims Table in memory shared by all the processes
+   *  @param num_claims Number of entries in claims
+   *  @param split_depth Depth at which subtrees are handed out
+   *  @param worker Number of this process, for subtrees past num_claims
+   *  @param num_workers Number of processes
+   */
+  void share_dfs(
+    std::atomic<bool> *claims,
+    unsigned int num_claims,
+    unsigned int split_depth,
+    unsigned int worker,
+    unsigned int num_workers);
+
+  /**
+   *  Whether the last formula from get_next_formula is for this process.
+   *  @return False if another process of a shared DFS claimed it
+   */
+  bool formula_is_ours() const
+  {
+    return formula_claimed;
+  }
+
   /**
    *  Class recording a reachability checkpoint.
    *  Currently likely broken; but this originally redorced a particular trace
@@ -319,6 +365,13 @@ public:
    */
   void save_checkpoint(const std::string &&fname) const;
 
+  /**
+   *  Print the number of ex_states cloned at context switch points so far,
+   *  and the time spent cloning them.
+   *  @param out Stream to print to.
+   */
+  static void print_clone_stats(std::ostream &out);
+
   /** GOTO functions we're operating over. */
   goto_functionst &goto_functions;
   /** Context we're operating upon */
@@ -329,6 +382,8 @@ public:
   bool has_complete_formula;
   /** State hashing is enabled */
   bool state_hashing;
+  /** States are hashed with fast_hash rather than crypto_hash */
+  bool fast_state_hashing;
   /** Functions dictate interleavings; perform no exploration.
    *  Used by --directed-interleavings */
   bool directed_interleavings;
@@ -338,6 +393,11 @@ public:
   optionst &options;
 
 protected:
+  /** Number of ex_states cloned by create_next_state */
+  static unsigned long clone_count;
+  /** Time spent in those clones */
+  static fine_timet clone_time;
+
   /** Stack of execution states representing current interleaving.
    *  See reachability_treet algorithm for how this is used. Is initialized
    *  with a single execution_statet in it, with a function call to "main" set
@@ -368,6 +428,8 @@ protected:
   bool por;
   /** Set of state hashes we've discovered */
   std::set<crypto_hash> hit_hashes;
+  /** Set of state hashes we've discovered, with --fast-state-hashing */
+  fast_hash_sett fast_hit_hashes;
   /** Message handler reference. */
   message_handlert &message_handler;
   /** Flag as to whether we're picking interleaving directions explicitly.
@@ -378,6 +440,28 @@ protected:
   /** Are we using the --schedule scheduling method? */
   bool schedule;
 
+  /** Claim the next subtree of a shared DFS, see share_dfs.
+   *  @return True if this process is to explore it */
+  bool claim_dfs_subtree();
+
+  /** Claim table shared with other processes; nullptr if not sharing */
+  std::atomic<bool> *dfs_claims;
+  unsigned int dfs_num_claims;
+  unsigned int dfs_split_depth;
+  unsigned int dfs_worker;
+  unsigned int dfs_num_workers;
+  /** Number of the next subtree at the split depth, in DFS order */
+  unsigned int dfs_next_subtree;
+  /** Whether the last formula generated is ours to check */
+  bool formula_claimed;
+
+  /** Whether explorations resume from unwind_checkpoint */
+  bool resume_unwinding;
+  /** A loop or recursion was cut in the current exploration */
+  bool unwinding_cut;
+  /** State to resume the next exploration from, see checkpoint_unwinding */
+  std::shared_ptr<execution_statet> unwind_checkpoint;
+
   /* Map to store the expression and thread ID,
    * which that expression belongs to. */
   std::unordered_map<expr2tc, std::list<unsigned int>, irep2_hash> vars_map;
@@ -7,37 +7,30 @@ Author: Daniel Kroening, kroening@kroening.com
 \*******************************************************************/
 
 #include <goto-symex/slice.h>
+#include <util/union_find.h>
 
-symex_slicet::symex_slicet(bool assume)
-  : ignored(0),
-    slice_assumes(assume),
-    add_to_deps([this](const symbol2t &s) -> bool {
-      return depends.insert(s.get_symbol_name()).second;
-    })
+symex_slicet::symex_slicet(bool assume) : ignored(0), slice_assumes(assume)
 {
 }
 
-bool symex_slicet::get_symbols(
-  const expr2tc &expr,
-  std::function<bool(const symbol2t &)> fn)
+void symex_slicet::add_to_deps(const std::vector<unsigned int> &ids)
 {
-  bool res = false;
-  expr->foreach_operand([this, &fn, &res](const expr2tc &e) {
-    if(!is_nil_expr(e))
-      res = get_symbols(e, fn) || res;
-    return res;
-  });
-
-  if(!is_symbol2t(expr))
-    return res;
-
-  const symbol2t &tmp = to_symbol2t(expr);
-  return fn(tmp) || res;
+  for(unsigned int id : ids)
+    depends.set(id);
+}
+
+bool symex_slicet::any_in_deps(const std::vector<unsigned int> &ids) const
+{
+  for(unsigned int id : ids)
+    if(depends.test(id))
+      return true;
+  return false;
 }
 
 void symex_slicet::slice(std::shared_ptr<symex_target_equationt> &eq)
 {
   depends.clear();
+  depends.resize(eq->num_symbol_ids());
 
   for(symex_target_equationt::SSA_stepst::reverse_iterator it =
         eq->SSA_steps.rbegin();
@@ -51,8 +44,8 @@ void symex_slicet::slice(symex_target_equationt::SSA_stept &SSA_step)
   switch(SSA_step.type)
   {
   case goto_trace_stept::ASSERT:
-    get_symbols(SSA_step.guard, add_to_deps);
-    get_symbols(SSA_step.cond, add_to_deps);
+    add_to_deps(SSA_step.guard_symbols);
+    add_to_deps(SSA_step.data_symbols);
     break;
 
   case goto_trace_stept::ASSUME:
@@ -60,8 +53,8 @@ void symex_slicet::slice(symex_target_equationt::SSA_stept &SSA_step)
       slice_assume(SSA_step);
     else
     {
-      get_symbols(SSA_step.guard, add_to_deps);
-      get_symbols(SSA_step.cond, add_to_deps);
+      add_to_deps(SSA_step.guard_symbols);
+      add_to_deps(SSA_step.data_symbols);
     }
     break;
 
@@ -83,11 +76,7 @@ void symex_slicet::slice(symex_target_equationt::SSA_stept &SSA_step)
 
 void symex_slicet::slice_assume(symex_target_equationt::SSA_stept &SSA_step)
 {
-  auto check_in_deps = [this](const symbol2t &s) -> bool {
-    return depends.find(s.get_symbol_name()) != depends.end();
-  };
-
-  if(!get_symbols(SSA_step.cond, check_in_deps))
+  if(!any_in_deps(SSA_step.data_symbols))
   {
     // we don't really need it
     SSA_step.ignore = true;
@@ -96,8 +85,8 @@ void symex_slicet::slice_assume(symex_target_equationt::SSA_stept &SSA_step)
   else
   {
     // If we need it, add the symbols to dependency
-    get_symbols(SSA_step.guard, add_to_deps);
-    get_symbols(SSA_step.cond, add_to_deps);
+    add_to_deps(SSA_step.guard_symbols);
+    add_to_deps(SSA_step.data_symbols);
   }
 }
 
@@ -105,11 +94,7 @@ void symex_slicet::slice_assignment(symex_target_equationt::SSA_stept &SSA_step)
 {
   assert(is_symbol2t(SSA_step.lhs));
 
-  auto check_in_deps = [this](const symbol2t &s) -> bool {
-    return depends.find(s.get_symbol_name()) != depends.end();
-  };
-
-  if(!get_symbols(SSA_step.lhs, check_in_deps))
+  if(!depends.test(SSA_step.lhs_symbol))
   {
     // we don't really need it
     SSA_step.ignore = true;
@@ -117,12 +102,12 @@ void symex_slicet::slice_assignment(symex_target_equationt::SSA_stept &SSA_step)
   }
   else
   {
-    get_symbols(SSA_step.guard, add_to_deps);
-    get_symbols(SSA_step.rhs, add_to_deps);
+    add_to_deps(SSA_step.guard_symbols);
+    add_to_deps(SSA_step.data_symbols);
 
     // Remove this symbol as we won't be seeing any references to it further
     // into the history.
-    depends.erase(to_symbol2t(SSA_step.lhs).get_symbol_name());
+    depends.reset(SSA_step.lhs_symbol);
   }
 }
 
@@ -130,11 +115,7 @@ void symex_slicet::slice_renumber(symex_target_equationt::SSA_stept &SSA_step)
 {
   assert(is_symbol2t(SSA_step.lhs));
 
-  auto check_in_deps = [this](const symbol2t &s) -> bool {
-    return depends.find(s.get_symbol_name()) != depends.end();
-  };
-
-  if(!get_symbols(SSA_step.lhs, check_in_deps))
+  if(!depends.test(SSA_step.lhs_symbol))
   {
     // we don't really need it
     SSA_step.ignore = true;
@@ -178,3 +159,127 @@ BigInt simple_slice(std::shared_ptr<symex_target_equationt> &eq)
 
   return ignored;
 }
+
+namespace
+{
+/* Slices a clone of an already sliced equation down to one group of its
+ * assertions. Steps the first slicing dropped stay dropped. */
+class symex_cone_slicet : public symex_slicet
+{
+public:
+  symex_cone_slicet() : symex_slicet(false)
+  {
+  }
+
+  void slice_group(
+    symex_target_equationt &eq,
+    const std::vector<unsigned int> &group_of,
+    unsigned int group)
+  {
+    depends.clear();
+    depends.resize(eq.num_symbol_ids());
+
+    // Assumptions restrict every assertion after them, so keep those that
+    // precede one of the group's assertions.
+    bool seen_assertion = false;
+    std::size_t i = eq.SSA_steps.size();
+    for(auto it = eq.SSA_steps.rbegin(); it != eq.SSA_steps.rend(); it++)
+    {
+      --i;
+      if(it->ignore)
+        continue;
+
+      if(
+        (it->is_assert() && group_of[i] != group) ||
+        (it->is_assume() && !seen_assertion))
+      {
+        it->ignore = true;
+        continue;
+      }
+
+      if(it->is_assert())
+        seen_assertion = true;
+
+      slice(*it);
+    }
+  }
+};
+} // namespace
+
+std::vector<std::shared_ptr<symex_target_equationt>>
+partition_assertions(const std::shared_ptr<symex_target_equationt> &eq)
+{
+  std::vector<std::shared_ptr<symex_target_equationt>> partitions;
+
+  // Connect each assignment's lhs with the symbols it reads, and the symbols
+  // of each assertion with each other. Assumptions are left out: they are
+  // copied into every partition they restrict instead of joining them.
+  // Symbols no assertion reads end up in classes of their own.
+  unsigned_union_find symbols;
+  symbols.resize(eq->num_symbol_ids());
+
+  auto join = [&symbols](unsigned int id, const std::vector<unsigned int> &ids) {
+    for(unsigned int other : ids)
+      symbols.make_union(id, other);
+  };
+
+  for(auto const &step : eq->SSA_steps)
+  {
+    if(step.ignore)
+      continue;
+
+    if(step.is_assignment() || step.is_renumber())
+    {
+      join(step.lhs_symbol, step.guard_symbols);
+      join(step.lhs_symbol, step.data_symbols);
+    }
+    else if(step.is_assert())
+    {
+      const std::vector<unsigned int> &first =
+        step.data_symbols.empty() ? step.guard_symbols : step.data_symbols;
+      if(first.empty())
+        continue;
+      join(first.front(), step.guard_symbols);
+      join(first.front(), step.data_symbols);
+    }
+  }
+
+  // Number the groups in order of their first assertion. Assertions that
+  // read no symbol at all share one group.
+  const unsigned int no_group = UINT_MAX;
+  std::vector<unsigned int> group_of(eq->SSA_steps.size(), no_group);
+  std::map<unsigned int, unsigned int> group_of_class;
+  unsigned int num_groups = 0;
+  std::size_t i = 0;
+  for(auto const &step : eq->SSA_steps)
+  {
+    if(step.is_assert() && !step.ignore)
+    {
+      unsigned int cls = UINT_MAX;
+      if(!step.data_symbols.empty())
+        cls = symbols.find(step.data_symbols.front());
+      else if(!step.guard_symbols.empty())
+        cls = symbols.find(step.guard_symbols.front());
+
+      auto res = group_of_class.emplace(cls, num_groups);
+      if(res.second)
+        ++num_groups;
+      group_of[i] = res.first->second;
+    }
+    ++i;
+  }
+
+  if(num_groups < 2)
+    return partitions;
+
+  for(unsigned int group = 0; group < num_groups; group++)
+  {
+    std::shared_ptr<symex_target_equationt> part =
+      std::dynamic_pointer_cast<symex_target_equationt>(eq->clone());
+    symex_cone_slicet cone_slice;
+    cone_slice.slice_group(*part, group_of, group);
+    partitions.push_back(part);
+  }
+
+  return partitions;
+}
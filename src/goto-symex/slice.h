@@ -9,31 +9,39 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_GOTO_SYMEX_SLICE_H
 #define CPROVER_GOTO_SYMEX_SLICE_H
 
+#include <boost/dynamic_bitset.hpp>
 #include <goto-symex/renaming.h>
 #include <goto-symex/symex_target_equation.h>
-#include <unordered_set>
 
 BigInt slice(std::shared_ptr<symex_target_equationt> &eq, bool slice_assume);
 BigInt simple_slice(std::shared_ptr<symex_target_equationt> &eq);
 
+/** Split the assertions of a sliced equation into groups whose cones of
+ *  influence share no symbol. Returns one clone of eq per group, sliced so
+ *  that only that group's assertions, the assumptions before them and their
+ *  cone are left; none if there are fewer than two groups. */
+std::vector<std::shared_ptr<symex_target_equationt>>
+partition_assertions(const std::shared_ptr<symex_target_equationt> &eq);
+
 class symex_slicet
 {
 public:
   symex_slicet(bool assume);
+  virtual ~symex_slicet() = default;
   void slice(std::shared_ptr<symex_target_equationt> &eq);
 
-  typedef std::unordered_set<std::string> symbol_sett;
-  symbol_sett depends;
+  /** Symbols (by symex_target_equationt symbol id) that the steps still to
+   *  be visited must define for the remaining ones to be needed */
+  boost::dynamic_bitset<> depends;
   BigInt ignored;
 
 protected:
   bool slice_assumes;
-  std::function<bool(const symbol2t &)> add_to_deps;
 
-  bool
-  get_symbols(const expr2tc &expr, std::function<bool(const symbol2t &)> fn);
+  void add_to_deps(const std::vector<unsigned int> &ids);
+  bool any_in_deps(const std::vector<unsigned int> &ids) const;
 
-  void slice(symex_target_equationt::SSA_stept &SSA_step);
+  virtual void slice(symex_target_equationt::SSA_stept &SSA_step);
   void slice_assume(symex_target_equationt::SSA_stept &SSA_step);
   void slice_assignment(symex_target_equationt::SSA_stept &SSA_step);
   void slice_renumber(symex_target_equationt::SSA_stept &SSA_step);
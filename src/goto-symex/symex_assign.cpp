@@ -51,8 +51,13 @@ goto_symext::goto_symext(
     k_induction(options.get_bool_option("k-induction")),
     base_case(options.get_bool_option("base-case")),
     forward_condition(options.get_bool_option("forward-condition")),
-    inductive_step(options.get_bool_option("inductive-step"))
+    inductive_step(options.get_bool_option("inductive-step")),
+    symex_templates(options.get_bool_option("symex-templates")),
+    deref_templates(std::make_shared<deref_templatest>())
 {
+  if(!options.get_bool_option("no-deref-memo"))
+    deref_memo = std::make_shared<dereferencet::memot>();
+
   const std::string &set = options.get_option("unwindset");
   unsigned int length = set.length();
 
@@ -112,6 +117,9 @@ goto_symext &goto_symext::operator=(const goto_symext &sym)
   base_case = sym.base_case;
   forward_condition = sym.forward_condition;
   inductive_step = sym.inductive_step;
+  symex_templates = sym.symex_templates;
+  deref_templates = sym.deref_templates;
+  deref_memo = sym.deref_memo;
   first_loop = sym.first_loop;
 
   valid_ptr_arr_name = sym.valid_ptr_arr_name;
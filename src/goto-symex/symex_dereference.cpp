@@ -20,7 +20,11 @@ void symex_dereference_statet::dereference_failure(
 {
   expr2tc g = guard.as_expr();
   goto_symex.replace_dynamic_allocation(g);
-  goto_symex.claim(not2tc(g), "dereference failure: " + msg);
+  not2tc claim_expr(g);
+  std::string claim_msg = "dereference failure: " + msg;
+  if(record != nullptr)
+    record->claims.emplace_back(claim_expr, claim_msg);
+  goto_symex.claim(claim_expr, claim_msg);
 }
 
 bool symex_dereference_statet::has_failed_symbol(
@@ -53,6 +57,17 @@ void symex_dereference_statet::get_value_set(
   value_setst::valuest &value_set)
 {
   state.value_set.get_value_set(expr, value_set);
+  if(record != nullptr)
+    record->value_sets.emplace_back(expr, value_set);
+}
+
+unsigned long symex_dereference_statet::get_value_set_version()
+{
+  // A template being recorded has to see every value set query
+  if(record != nullptr)
+    return 0;
+
+  return state.value_set.version;
 }
 
 void symex_dereference_statet::rename(expr2tc &expr)
@@ -68,6 +83,32 @@ void symex_dereference_statet::dump_internal_state(
 }
 
 bool symex_dereference_statet::is_live_variable(const expr2tc &symbol)
+{
+  bool live = check_live_variable(symbol);
+  if(record != nullptr)
+    record->live_variables.emplace_back(symbol, live);
+  return live;
+}
+
+bool symex_dereference_statet::same_answers(
+  const goto_symext::deref_templatet &t)
+{
+  for(auto const &query : t.value_sets)
+  {
+    value_setst::valuest value_set;
+    state.value_set.get_value_set(query.first, value_set);
+    if(value_set != query.second)
+      return false;
+  }
+
+  for(auto const &query : t.live_variables)
+    if(check_live_variable(query.first) != query.second)
+      return false;
+
+  return true;
+}
+
+bool symex_dereference_statet::check_live_variable(const expr2tc &symbol)
 {
   expr2tc sym = symbol;
 
@@ -114,11 +155,36 @@ void goto_symext::dereference(expr2tc &expr, dereferencet::modet mode)
   symex_dereference_statet symex_dereference_state(*this, *cur_state);
 
   dereferencet dereference(ns, new_context, options, symex_dereference_state);
+  dereference.set_memo(deref_memo.get());
 
   // needs to be renamed to level 1
   assert(!cur_state->call_stack.empty());
   cur_state->top().level1.rename(expr);
 
+  // Met this expression before? If its pointers still point at the same
+  // objects, the result is the same: only the claims have to be made again.
+  bool templates =
+    symex_templates &&
+    (mode == dereferencet::READ || mode == dereferencet::WRITE);
+  deref_templatet record;
+  expr2tc orig_expr = expr;
+  unsigned int invalid_counter = dereferencet::get_invalid_counter();
+  if(templates)
+  {
+    auto it = deref_templates->find(expr);
+    if(
+      it != deref_templates->end() && it->second.mode == mode &&
+      symex_dereference_state.same_answers(it->second))
+    {
+      for(auto const &c : it->second.claims)
+        claim(c.first, c.second);
+      expr = it->second.result;
+      return;
+    }
+
+    symex_dereference_state.record = &record;
+  }
+
   guardt guard;
   switch(mode)
   {
@@ -141,4 +207,19 @@ void goto_symext::dereference(expr2tc &expr, dereferencet::modet mode)
   default:
     dereference.dereference_expr(expr, guard, mode);
   }
+
+  // Nothing pointed anywhere, there's little to save by keeping it
+  if(!templates || record.value_sets.empty())
+    return;
+
+  // Failed symbols are fresh each time
+  if(invalid_counter != dereferencet::get_invalid_counter())
+    return;
+
+  if(deref_templates->size() >= 65536)
+    deref_templates->clear();
+
+  record.mode = mode;
+  record.result = expr;
+  (*deref_templates)[orig_expr] = std::move(record);
 }
@@ -11,6 +11,7 @@
 #include <cassert>
 #include <goto-symex/execution_state.h>
 #include <goto-symex/goto_symex.h>
+#include <goto-symex/reachability_tree.h>
 #include <langapi/language_util.h>
 #include <util/arith_tools.h>
 #include <util/base_type.h>
@@ -211,6 +212,8 @@ void goto_symext::symex_function_call_code(const expr2tc &expr)
   // see if it's too much
   if(get_unwind_recursion(identifier, unwinding_counter))
   {
+    art1->record_unwinding_cut();
+
     if(!no_unwinding_assertions)
     {
       claim(gen_false_expr(), "recursion unwinding assertion");
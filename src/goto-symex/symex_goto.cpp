@@ -10,6 +10,7 @@
 #include <cassert>
 #include <fstream>
 #include <goto-symex/goto_symex.h>
+#include <goto-symex/reachability_tree.h>
 #include <goto-symex/slice.h>
 #include <goto-symex/symex_target_equation.h>
 #include <iostream>
@@ -111,6 +112,7 @@ void goto_symext::symex_goto(const expr2tc &old_guard)
 
     if(get_unwind(cur_state->source, unwind))
     {
+      art1->record_unwinding_cut();
       loop_bound_exceeded(new_guard);
 
       // reset unwinding
@@ -98,6 +98,20 @@ void goto_symext::symex_step(reachability_treet &art)
 
   const goto_programt::instructiont &instruction = *cur_state->source.pc;
 
+  // A loop is about to reach its unwinding bound: later explorations with a
+  // higher bound can start over from here
+  if(instruction.is_backwards_goto())
+  {
+    BigInt this_loop_max_unwind = max_unwind;
+    if(unwind_set.count(instruction.loop_number) != 0)
+      this_loop_max_unwind = unwind_set[instruction.loop_number];
+
+    auto it = cur_state->loop_iterations.find(instruction.loop_number);
+    BigInt unwind = (it == cur_state->loop_iterations.end()) ? 0 : it->second;
+    if(this_loop_max_unwind != 0 && unwind + 1 >= this_loop_max_unwind)
+      art.checkpoint_unwinding();
+  }
+
   // depth exceeded?
   {
     if(depth_limit != 0 && cur_state->depth > depth_limit)
@@ -407,6 +421,18 @@ void goto_symext::run_intrinsic(
   {
     intrinsic_memset(art, func_call);
   }
+  else if(symname == "c:@F@__ESBMC_memcpy")
+  {
+    intrinsic_memcpy(art, func_call, "c:@F@__memcpy_impl");
+  }
+  else if(symname == "c:@F@__ESBMC_memmove")
+  {
+    intrinsic_memcpy(art, func_call, "c:@F@__memmove_impl");
+  }
+  else if(symname == "c:@F@__ESBMC_strlen")
+  {
+    intrinsic_strlen(art, func_call);
+  }
   else if(has_prefix(symname, "c:@F@__ESBMC_overflow"))
   {
     bool is_mult = has_prefix(symname, "c:@F@__ESBMC_overflow_smul") ||
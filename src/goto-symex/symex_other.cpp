@@ -89,7 +89,7 @@ void goto_symext::symex_decl(const expr2tc code)
   statet::framet &frame = cur_state->top();
   do
   {
-    unsigned &index = cur_state->variable_instance_nums[identifier];
+    unsigned &index = cur_state->variable_instance_nums.write()[identifier];
     frame.level1.rename(l1_sym, ++index);
     l1_sym->level1_num = index;
   } while(frame.declaration_history.find(renaming::level2t::name_record(
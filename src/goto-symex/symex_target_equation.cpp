@@ -42,6 +42,8 @@ void symex_target_equationt::assignment(
   SSA_step.source = source;
   SSA_step.stack_trace = stack_trace;
   SSA_step.loop_number = loop_number;
+  intern_exprs_of(SSA_step);
+  record_symbol_ids_of(SSA_step);
 
   if(debug_print)
     SSA_step.output(ns, std::cout);
@@ -80,6 +82,8 @@ void symex_target_equationt::assumption(
   SSA_step.type = goto_trace_stept::ASSUME;
   SSA_step.source = source;
   SSA_step.loop_number = loop_number;
+  intern_exprs_of(SSA_step);
+  record_symbol_ids_of(SSA_step);
 
   if(debug_print)
     SSA_step.output(ns, std::cout);
@@ -103,6 +107,8 @@ void symex_target_equationt::assertion(
   SSA_step.comment = msg;
   SSA_step.stack_trace = stack_trace;
   SSA_step.loop_number = loop_number;
+  intern_exprs_of(SSA_step);
+  record_symbol_ids_of(SSA_step);
 
   if(debug_print)
     SSA_step.output(ns, std::cout);
@@ -124,12 +130,98 @@ void symex_target_equationt::renumber(
   SSA_step.rhs = size;
   SSA_step.type = goto_trace_stept::RENUMBER;
   SSA_step.source = source;
+  intern_exprs_of(SSA_step);
+  record_symbol_ids_of(SSA_step);
 
   if(debug_print)
     SSA_step.output(ns, std::cout);
 }
 
+unsigned int symex_target_equationt::get_symbol_id(const symbol2t &sym)
+{
+  // Mirror symbol_data::get_symbol_name: fields that aren't part of the name
+  // at this renaming level mustn't distinguish symbols.
+  symbol_keyt key = {sym.thename.get_no(), 0, 0, 0, 0, 0};
+  switch(sym.rlevel)
+  {
+  case symbol2t::level0:
+  case symbol2t::level1_global:
+    break;
+  case symbol2t::level2:
+    key.node_num = sym.node_num;
+    key.level2_num = sym.level2_num;
+    /* fallthrough */
+  case symbol2t::level1:
+    key.level = sym.rlevel;
+    key.level1_num = sym.level1_num;
+    key.thread_num = sym.thread_num;
+    break;
+  case symbol2t::level2_global:
+    key.level = sym.rlevel;
+    key.node_num = sym.node_num;
+    key.level2_num = sym.level2_num;
+    break;
+  }
+
+  return symbol_ids->emplace(key, symbol_ids->size()).first->second;
+}
+
+void symex_target_equationt::get_symbol_ids(
+  const expr2tc &expr,
+  std::vector<unsigned int> &ids)
+{
+  if(is_nil_expr(expr))
+    return;
+
+  if(is_symbol2t(expr))
+  {
+    ids.push_back(get_symbol_id(to_symbol2t(expr)));
+    return;
+  }
+
+  expr->foreach_operand(
+    [this, &ids](const expr2tc &e) { get_symbol_ids(e, ids); });
+}
+
+void symex_target_equationt::intern_exprs_of(SSA_stept &step)
+{
+  if(!intern_table)
+    return;
+
+  step.guard = intern_table->intern(step.guard);
+  step.lhs = intern_table->intern(step.lhs);
+  step.original_lhs = intern_table->intern(step.original_lhs);
+  step.rhs = intern_table->intern(step.rhs);
+  step.cond = intern_table->intern(step.cond);
+}
+
+void symex_target_equationt::record_symbol_ids_of(SSA_stept &step)
+{
+  if(!record_symbol_ids)
+    return;
+
+  get_symbol_ids(step.guard, step.guard_symbols);
+
+  if(step.is_assignment() || step.is_renumber())
+  {
+    step.lhs_symbol = get_symbol_id(to_symbol2t(step.lhs));
+    if(step.is_assignment())
+      get_symbol_ids(step.rhs, step.data_symbols);
+  }
+  else
+    get_symbol_ids(step.cond, step.data_symbols);
+}
+
 void symex_target_equationt::convert(smt_convt &smt_conv)
+{
+  smt_convt::ast_vec assertions = convert_steps(smt_conv);
+
+  if(!assertions.empty())
+    smt_conv.assert_ast(
+      smt_conv.make_n_ary(&smt_conv, &smt_convt::mk_or, assertions));
+}
+
+smt_convt::ast_vec symex_target_equationt::convert_steps(smt_convt &smt_conv)
 {
   smt_convt::ast_vec assertions;
   smt_astt assumpt_ast = smt_conv.convert_ast(gen_true_expr());
@@ -137,9 +229,7 @@ void symex_target_equationt::convert(smt_convt &smt_conv)
   for(auto &SSA_step : SSA_steps)
     convert_internal_step(smt_conv, assumpt_ast, assertions, SSA_step);
 
-  if(!assertions.empty())
-    smt_conv.assert_ast(
-      smt_conv.make_n_ary(&smt_conv, &smt_convt::mk_or, assertions));
+  return assertions;
 }
 
 void symex_target_equationt::convert_internal_step(
@@ -228,6 +318,142 @@ void symex_target_equationt::convert_internal_step(
   }
 }
 
+/* Minimum number of SSA steps held by one solver context pushed by
+ * convert_incremental. A longer common prefix can only be reused up to the
+ * end of the last context that lies completely inside it. */
+static const unsigned int min_encoded_layer_size = 128;
+
+bool symex_target_equationt::steps_match(const SSA_stept &a, const SSA_stept &b)
+  const
+{
+  if(a.type != b.type)
+    return false;
+
+  // Assignments define fresh SSA symbols, so whether the slicer dropped one
+  // doesn't change the meaning of the steps around it.
+  if(!a.is_assignment() && a.ignore != b.ignore)
+    return false;
+
+  if(a.guard != b.guard)
+    return false;
+
+  if(a.is_renumber())
+    return a.lhs == b.lhs && a.rhs == b.rhs;
+
+  if(a.is_output())
+    return a.output_args == b.output_args;
+
+  return a.cond == b.cond;
+}
+
+unsigned int symex_target_equationt::convert_incremental(
+  smt_convt &smt_conv,
+  symex_target_equationt *prev)
+{
+  unsigned int shared = 0;
+  std::vector<SSA_stept *> late_steps;
+  SSA_stepst::iterator it = SSA_steps.begin();
+
+  if(prev != nullptr)
+  {
+    // Drop the assertions checked on the previous run
+    if(prev->query_pushed)
+      smt_conv.pop_ctx();
+    prev->query_pushed = false;
+
+    unsigned int common = 0;
+    SSA_stepst::iterator pit = prev->SSA_steps.begin();
+    while(it != SSA_steps.end() && pit != prev->SSA_steps.end() &&
+          steps_match(*it, *pit))
+    {
+      ++it;
+      ++pit;
+      ++common;
+    }
+
+    // Only contexts that hold nothing but common steps can be kept
+    encoded_layers = std::move(prev->encoded_layers);
+    while(!encoded_layers.empty() && encoded_layers.back().end > common)
+    {
+      smt_conv.pop_ctx();
+      encoded_layers.pop_back();
+    }
+
+    std::size_t num_assertions = 0;
+    if(!encoded_layers.empty())
+    {
+      shared = encoded_layers.back().end;
+      num_assertions = encoded_layers.back().num_assertions;
+    }
+
+    encoded_assertions = std::move(prev->encoded_assertions);
+    encoded_assertions.resize(num_assertions);
+    discharged_assertions =
+      std::min(prev->discharged_assertions, encoded_assertions.size());
+
+    it = SSA_steps.begin();
+    pit = prev->SSA_steps.begin();
+    for(unsigned int i = 0; i < shared; i++, ++it, ++pit)
+    {
+      // Assignments the slicer dropped last time may be needed now
+      if(pit->ignore && !it->ignore)
+      {
+        late_steps.push_back(&*it);
+        continue;
+      }
+
+      it->guard_ast = pit->guard_ast;
+      it->cond_ast = pit->cond_ast;
+      it->converted_output_args = pit->converted_output_args;
+    }
+  }
+
+  smt_astt assumpt_ast = encoded_layers.empty()
+                           ? smt_conv.convert_ast(gen_true_expr())
+                           : encoded_layers.back().assumpt_ast;
+
+  smt_conv.push_ctx();
+  for(auto *step : late_steps)
+    convert_internal_step(smt_conv, assumpt_ast, encoded_assertions, *step);
+
+  // Open a new context whenever control flow went backwards, which usually
+  // is the start of a loop iteration: that's where the next, deeper,
+  // unwinding of the program diverges from this one.
+  unsigned int idx = shared, layer_start = shared;
+  const SSA_stept *last = nullptr;
+  for(; it != SSA_steps.end(); ++it, ++idx)
+  {
+    if(
+      idx - layer_start >= min_encoded_layer_size && last != nullptr &&
+      last->source.is_set && it->source.is_set &&
+      it->source.pc->location_number < last->source.pc->location_number)
+    {
+      encoded_layers.push_back({idx, assumpt_ast, encoded_assertions.size()});
+      smt_conv.push_ctx();
+      layer_start = idx;
+    }
+
+    convert_internal_step(smt_conv, assumpt_ast, encoded_assertions, *it);
+    last = &*it;
+  }
+  encoded_layers.push_back({idx, assumpt_ast, encoded_assertions.size()});
+
+  // Check the assertions not discharged yet in a context of their own
+  smt_conv.push_ctx();
+  query_pushed = true;
+
+  smt_convt::ast_vec pending(
+    encoded_assertions.begin() + discharged_assertions,
+    encoded_assertions.end());
+  if(pending.empty())
+    smt_conv.assert_ast(smt_conv.convert_ast(gen_false_expr()));
+  else
+    smt_conv.assert_ast(
+      smt_conv.make_n_ary(&smt_conv, &smt_convt::mk_or, pending));
+
+  return shared - late_steps.size();
+}
+
 void symex_target_equationt::output(std::ostream &out) const
 {
   for(const auto &SSA_step : SSA_steps)
@@ -474,6 +700,7 @@ std::shared_ptr<symex_targett> runtime_encoded_equationt::clone() const
   auto nthis = std::shared_ptr<runtime_encoded_equationt>(
     new runtime_encoded_equationt(*this));
   nthis->cvt_progress = nthis->SSA_steps.end();
+  nthis->symbol_ids = std::make_shared<symbol_id_mapt>();
   return nthis;
 }
 
@@ -502,11 +729,11 @@ tvt runtime_encoded_equationt::ask_solver_question(const expr2tc &question)
   // results are true, false, both.
   push_ctx();
   conv.assert_ast(q);
-  smt_convt::resultt res1 = conv.dec_solve();
+  smt_convt::resultt res1 = conv.solve_with_refinement();
   pop_ctx();
   push_ctx();
   conv.assert_ast(conv.invert_ast(q));
-  smt_convt::resultt res2 = conv.dec_solve();
+  smt_convt::resultt res2 = conv.solve_with_refinement();
   pop_ctx();
 
   // So; which result?
@@ -18,7 +18,9 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <list>
 #include <map>
 #include <solvers/smt/smt_conv.h>
+#include <unordered_map>
 #include <util/config.h>
+#include <util/expr_intern.h>
 #include <util/irep2.h>
 #include <util/namespace.h>
 #include <vector>
@@ -28,11 +30,15 @@ class symex_target_equationt : public symex_targett
 public:
   class SSA_stept;
 
-  symex_target_equationt(const namespacet &_ns) : ns(_ns)
+  symex_target_equationt(const namespacet &_ns)
+    : ns(_ns), symbol_ids(std::make_shared<symbol_id_mapt>())
   {
     debug_print = config.options.get_bool_option("symex-ssa-trace");
     ssa_trace = config.options.get_bool_option("ssa-trace");
     ssa_smt_trace = config.options.get_bool_option("ssa-smt-trace");
+    record_symbol_ids = !config.options.get_bool_option("no-slice");
+    if(config.options.get_bool_option("intern-exprs"))
+      intern_table = std::make_shared<expr_intern_tablet>();
   }
 
   // assignment to a variable - must be symbol
@@ -79,12 +85,37 @@ public:
     const sourcet &source) override;
 
   virtual void convert(smt_convt &smt_conv);
+
+  /** Convert every SSA step without asserting anything about the assertions.
+   *  @return The negation of each assertion that wasn't sliced away, in the
+   *          order of SSA_steps. */
+  smt_convt::ast_vec convert_steps(smt_convt &smt_conv);
   void convert_internal_step(
     smt_convt &smt_conv,
     smt_astt &assumpt_ast,
     smt_convt::ast_vec &assertions,
     SSA_stept &s);
 
+  /** Convert this equation on top of the solver state left by a previous
+   *  equation. Steps shared with the longest common prefix of prev are not
+   *  re-encoded: the solver contexts holding them are kept, the rest are
+   *  popped and the remaining steps are encoded in freshly pushed contexts.
+   *  Assertions that were already discharged by prev are not checked again.
+   *  The disjunction of pending assertions is asserted in one more context,
+   *  which is popped by the next call. The encoding state of prev is moved
+   *  into this equation.
+   *  @param smt_conv Solver that prev was converted into.
+   *  @param prev Previously converted equation, or nullptr on the first run.
+   *  @return Number of SSA steps whose encoding was reused. */
+  unsigned int convert_incremental(smt_convt &smt_conv, symex_target_equationt *prev);
+
+  /** Record that the solver found all pending assertions to hold, so that
+   *  later calls to convert_incremental don't check them again. */
+  void discharge_assertions()
+  {
+    discharged_assertions = encoded_assertions.size();
+  }
+
   class SSA_stept
   {
   public:
@@ -141,13 +172,20 @@ public:
     // for slicing
     bool ignore;
 
+    // Dense ids (see get_symbol_id) of the symbol an assignment or renumber
+    // defines, of the symbols in the guard, and of those in the rhs or cond.
+    // Only recorded when slicing is enabled.
+    unsigned int lhs_symbol;
+    std::vector<unsigned int> guard_symbols;
+    std::vector<unsigned int> data_symbols;
+
     // for visibility
     bool hidden;
 
     // for bidirectional search
     unsigned loop_number;
 
-    SSA_stept() : ignore(false), hidden(false)
+    SSA_stept() : ignore(false), lhs_symbol(0), hidden(false)
     {
     }
 
@@ -187,28 +225,114 @@ public:
 
   void check_for_duplicate_assigns() const;
 
+  /** Number of distinct renamed symbols seen in the recorded steps; all the
+   *  symbol ids in SSA steps are below it. */
+  unsigned int num_symbol_ids() const
+  {
+    return symbol_ids->size();
+  }
+
   void clear()
   {
     SSA_steps.clear();
   }
 
+  /** Table of the expressions in the recorded steps with --intern-exprs,
+   *  shared by all clones of this equation; nullptr otherwise. */
+  const std::shared_ptr<expr_intern_tablet> &get_intern_table() const
+  {
+    return intern_table;
+  }
+
   unsigned int clear_assertions();
 
   std::shared_ptr<symex_targett> clone() const override
   {
-    // No pointers or anything that requires ownership modification, can just
-    // duplicate self.
-    return std::shared_ptr<symex_targett>(new symex_target_equationt(*this));
+    // Nothing that requires ownership modification but the symbol ids: a
+    // clone goes on to record a different interleaving, so it gets its own
+    // copy of them, and a fresh formula starts from none.
+    auto eq = std::make_shared<symex_target_equationt>(*this);
+    if(SSA_steps.empty())
+      eq->symbol_ids = std::make_shared<symbol_id_mapt>();
+    else
+      eq->symbol_ids = std::make_shared<symbol_id_mapt>(*symbol_ids);
+    return eq;
   }
 
   void push_ctx() override;
   void pop_ctx() override;
 
 protected:
+  bool steps_match(const SSA_stept &a, const SSA_stept &b) const;
+
+  /** Map a renamed symbol to a dense id, without building its name. Symbols
+   *  get the same id iff they have the same get_symbol_name(). */
+  unsigned int get_symbol_id(const symbol2t &sym);
+  void get_symbol_ids(const expr2tc &expr, std::vector<unsigned int> &ids);
+  void intern_exprs_of(SSA_stept &step);
+  void record_symbol_ids_of(SSA_stept &step);
+
+  struct symbol_keyt
+  {
+    unsigned int name;
+    unsigned int level;
+    unsigned int level1_num;
+    unsigned int thread_num;
+    unsigned int node_num;
+    unsigned int level2_num;
+
+    bool operator==(const symbol_keyt &ref) const
+    {
+      return name == ref.name && level == ref.level &&
+             level1_num == ref.level1_num && thread_num == ref.thread_num &&
+             node_num == ref.node_num && level2_num == ref.level2_num;
+    }
+  };
+
+  struct symbol_key_hash
+  {
+    size_t operator()(const symbol_keyt &k) const
+    {
+      size_t h = k.name;
+      h = h * 31 + k.level;
+      h = h * 31 + k.level1_num;
+      h = h * 31 + k.thread_num;
+      h = h * 31 + k.node_num;
+      h = h * 31 + k.level2_num;
+      return h;
+    }
+  };
+
+  typedef std::unordered_map<symbol_keyt, unsigned int, symbol_key_hash>
+    symbol_id_mapt;
+
   const namespacet &ns;
   bool debug_print;
   bool ssa_trace;
   bool ssa_smt_trace;
+  bool record_symbol_ids;
+
+  /** Copied by clone(), so that a clone agrees on the ids of the steps it
+   *  inherits, but only the symbols of its own interleaving widen the
+   *  slicer's bitsets. */
+  std::shared_ptr<symbol_id_mapt> symbol_ids;
+
+  /** With --intern-exprs, equal expressions in the steps share one node */
+  std::shared_ptr<expr_intern_tablet> intern_table;
+
+  /** One solver context pushed by convert_incremental. Records the state of
+   *  the encoding after all the SSA steps before `end` were converted. */
+  struct encoded_layert
+  {
+    unsigned int end;
+    smt_astt assumpt_ast;
+    std::size_t num_assertions;
+  };
+
+  std::vector<encoded_layert> encoded_layers;
+  smt_convt::ast_vec encoded_assertions;
+  std::size_t discharged_assertions = 0;
+  bool query_pushed = false;
 };
 
 class runtime_encoded_equationt : public symex_target_equationt
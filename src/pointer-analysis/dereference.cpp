@@ -6,6 +6,7 @@ Author: Daniel Kroening, kroening@kroening.com
 
 \*******************************************************************/
 
+#include <boost/functional/hash.hpp>
 #include <cassert>
 #include <langapi/language_util.h>
 #include <pointer-analysis/dereference.h>
@@ -31,6 +32,26 @@ Author: Daniel Kroening, kroening@kroening.com
 
 // global data, horrible
 unsigned int dereferencet::invalid_counter = 0;
+std::size_t dereferencet::memot::hits = 0;
+std::size_t dereferencet::memot::misses = 0;
+
+std::size_t dereferencet::memot::key_hash::operator()(const keyt &k) const
+{
+  std::size_t h = k.pointer.crc();
+  boost::hash_combine(h, k.version);
+  boost::hash_combine(h, k.type.crc());
+  boost::hash_combine(h, (uint8_t)k.mode);
+  boost::hash_combine(h, k.guard.crc());
+  if(!is_nil_expr(k.lexical_offset))
+    boost::hash_combine(h, k.lexical_offset.crc());
+  return h;
+}
+
+void dereferencet::memot::print_stats(std::ostream &out)
+{
+  out << "Dereference memo: " << hits << " hits, " << misses << " misses"
+      << std::endl;
+}
 
 static inline bool is_non_scalar_expr(const expr2tc &e)
 {
@@ -462,6 +483,42 @@ expr2tc dereferencet::dereference(
 
   type2tc type = to_type;
 
+  // Dereferenced this pointer in the same way, against the same value sets,
+  // before? Then the result is the same, as long as the objects it may point
+  // at are as live as they were: only the claims have to be made again.
+  memot::keyt key;
+  memo_entryt entry;
+  unsigned int old_invalid_counter = invalid_counter;
+  bool memoise =
+    memo != nullptr && recording == nullptr && (mode == READ || mode == WRITE);
+  if(memoise)
+  {
+    key.version = dereference_callback.get_value_set_version();
+    memoise = key.version != 0;
+  }
+
+  if(memoise)
+  {
+    key.pointer = src;
+    key.type = type;
+    key.mode = mode;
+    key.guard = guard.as_expr();
+    key.lexical_offset = lexical_offset;
+    key.block_assertions = block_assertions;
+
+    memot::entriest::const_iterator it = memo->entries.find(key);
+    if(it != memo->entries.end() && same_liveness(it->second))
+    {
+      memot::hits++;
+      for(auto const &c : it->second.claims)
+        dereference_callback.dereference_failure(c.property, c.msg, c.guard);
+      return it->second.value;
+    }
+
+    memot::misses++;
+    recording = &entry;
+  }
+
   // collect objects dest may point to
   value_setst::valuest points_to_set;
 
@@ -470,7 +527,7 @@ expr2tc dereferencet::dereference(
   // now build big case split
   // only "good" objects
 
-  expr2tc value;
+  std::vector<std::pair<expr2tc, expr2tc>> cases;
 
   for(value_setst::valuest::const_iterator it = points_to_set.begin();
       it != points_to_set.end();
@@ -482,18 +539,19 @@ expr2tc dereferencet::dereference(
       *it, mode, src, type, guard, lexical_offset, pointer_guard);
 
     if(!is_nil_expr(new_value))
-    {
-      if(is_nil_expr(value))
-      {
-        value = new_value;
-      }
-      else
-      {
-        // Chain a big if-then-else case.
-        value = if2tc(type, pointer_guard, new_value, value);
-      }
-    }
+      cases.emplace_back(pointer_guard, new_value);
+  }
+
+  expr2tc value;
+  if(linear_case_split)
+  {
+    // Chain a big if-then-else case.
+    for(auto const &c : cases)
+      value = is_nil_expr(value) ? c.second
+                                 : if2tc(type, c.first, c.second, value);
   }
+  else if(!cases.empty())
+    value = make_case_split(cases, 0, cases.size(), type, nullptr);
 
   if(is_nil_expr(value) && mode != INTERNAL)
   {
@@ -509,9 +567,67 @@ expr2tc dereferencet::dereference(
     internal_items.clear();
   }
 
+  if(memoise)
+  {
+    recording = nullptr;
+
+    // Failed symbols are fresh each time
+    if(invalid_counter == old_invalid_counter)
+    {
+      if(memo->entries.size() >= 65536)
+        memo->entries.clear();
+
+      entry.value = value;
+      memo->entries[key] = std::move(entry);
+    }
+  }
+
   return value;
 }
 
+expr2tc dereferencet::make_case_split(
+  const std::vector<std::pair<expr2tc, expr2tc>> &cases,
+  std::size_t begin,
+  std::size_t end,
+  const type2tc &type,
+  expr2tc *any_guard) const
+{
+  if(end - begin == 1)
+  {
+    if(any_guard != nullptr)
+      *any_guard = cases[begin].first;
+    return cases[begin].second;
+  }
+
+  // The later half takes priority: pick from it if any of its guards hold
+  std::size_t mid = end - (end - begin) / 2;
+  expr2tc later_guard, earlier_guard;
+  expr2tc later = make_case_split(cases, mid, end, type, &later_guard);
+  expr2tc earlier = make_case_split(
+    cases, begin, mid, type, any_guard != nullptr ? &earlier_guard : nullptr);
+
+  if(any_guard != nullptr)
+    *any_guard = or2tc(later_guard, earlier_guard);
+  return if2tc(type, later_guard, later, earlier);
+}
+
+bool dereferencet::same_liveness(const memo_entryt &entry)
+{
+  for(auto const &query : entry.live_variables)
+    if(dereference_callback.is_live_variable(query.first) != query.second)
+      return false;
+
+  return true;
+}
+
+bool dereferencet::is_live_variable(const expr2tc &sym)
+{
+  bool live = dereference_callback.is_live_variable(sym);
+  if(recording != nullptr)
+    recording->live_variables.emplace_back(sym, live);
+  return live;
+}
+
 expr2tc dereferencet::make_failed_symbol(const type2tc &out_type)
 {
   type2tc the_type;
@@ -1659,7 +1775,11 @@ void dereferencet::dereference_failure(
 {
   // This just wraps dereference failure in a no-pointer-check check.
   if(!options.get_bool_option("no-pointer-check") && !block_assertions)
+  {
+    if(recording != nullptr)
+      recording->claims.push_back({error_class, error_name, guard});
     dereference_callback.dereference_failure(error_class, error_name, guard);
+  }
 }
 
 void dereferencet::bad_base_type_failure(
@@ -1856,7 +1976,7 @@ void dereferencet::valid_check(
       // Otherwise, this is a pointer to some kind of lexical variable, with
       // either global or function-local scope. Ask symex to determine if
       // it's live.
-      if(!dereference_callback.is_live_variable(symbol))
+      if(!is_live_variable(symbol))
       {
         // Any access where this guard is true -> failure
         dereference_failure(
@@ -11,6 +11,7 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <pointer-analysis/value_sets.h>
 #include <set>
+#include <unordered_map>
 #include <util/expr.h>
 #include <util/guard.h>
 #include <util/namespace.h>
@@ -127,6 +128,15 @@ public:
   virtual void
   get_value_set(const expr2tc &expr, value_setst::valuest &value_set) = 0;
 
+  /** Version of the value sets that get_value_set answers from. While the
+   *  version stays the same, so do the answers, and dereferences may be
+   *  reused from a dereferencet::memot.
+   *  @return The version, or zero if no dereference should be reused. */
+  virtual unsigned long get_value_set_version()
+  {
+    return 0;
+  }
+
   /** Check whether a failed symbol already exists for the given symbol.
    *  This is legacy, and will be removed at some point soon. */
   virtual bool
@@ -188,14 +198,24 @@ public:
       new_context(_new_context),
       options(_options),
       dereference_callback(_dereference_callback),
-      block_assertions(false)
+      block_assertions(false),
+      memo(nullptr),
+      recording(nullptr)
   {
     is_big_endian =
       (config.ansi_c.endianess == configt::ansi_ct::IS_BIG_ENDIAN);
+    linear_case_split = options.get_bool_option("linear-case-split");
   }
 
   virtual ~dereferencet() = default;
 
+  /** Number of failed symbols generated so far. A dereference that made one
+   *  can't be repeated by reusing its result, as each gets a fresh symbol. */
+  static unsigned get_invalid_counter()
+  {
+    return invalid_counter;
+  }
+
   /** The different ways in which a pointer may be accessed. */
   typedef enum
   {
@@ -205,6 +225,72 @@ public:
     INTERNAL, /// Calling code only wants the internal value-set data.
   } modet;
 
+  /** A result of dereference(), and what it depends on besides the value set
+   *  of the pointer: the liveness queries made, with their answers, and the
+   *  dereference failure claims generated. */
+  struct memo_entryt
+  {
+    struct claimt
+    {
+      std::string property;
+      std::string msg;
+      guardt guard;
+    };
+
+    expr2tc value;
+    std::vector<std::pair<expr2tc, bool>> live_variables;
+    std::vector<claimt> claims;
+  };
+
+  /** Results of dereference(), by the pointer dereferenced, the version of the
+   *  value sets it was dereferenced against, and the type, mode, guard and
+   *  lexical offset of the access. The same pointer is often dereferenced
+   *  again and again in one statement and the ones after it; until its value
+   *  set changes, building the case split over what it points at again gives
+   *  the same result. */
+  class memot
+  {
+  public:
+    struct keyt
+    {
+      expr2tc pointer;
+      unsigned long version;
+      type2tc type;
+      modet mode;
+      expr2tc guard;
+      expr2tc lexical_offset;
+      bool block_assertions;
+
+      bool operator==(const keyt &ref) const
+      {
+        return version == ref.version && mode == ref.mode &&
+               block_assertions == ref.block_assertions &&
+               pointer == ref.pointer && type == ref.type &&
+               guard == ref.guard && lexical_offset == ref.lexical_offset;
+      }
+    };
+
+    struct key_hash
+    {
+      std::size_t operator()(const keyt &k) const;
+    };
+
+    typedef std::unordered_map<keyt, memo_entryt, key_hash> entriest;
+    entriest entries;
+
+    static void print_stats(std::ostream &out);
+
+    static std::size_t hits;
+    static std::size_t misses;
+  };
+
+  /** Reuse dereferences from, and add them to, the given memo; nullptr to not
+   *  reuse any. */
+  void set_memo(memot *_memo)
+  {
+    memo = _memo;
+  }
+
   /** Take an expression and dereference it.
    *  This will descend through the whole of the expression given, and
    *  dereference any dereferences contained within it. The given expr will
@@ -248,6 +334,9 @@ private:
   /** Whether or not we're operating in a big endian environment. Value for this
    *  is taken from config.ansi_c.endianness. */
   bool is_big_endian;
+  /** Whether to combine the objects a pointer may point at into a chain of
+   *  ifs, rather than a balanced tree. Corresponds to --linear-case-split */
+  bool linear_case_split;
   /** List of internal state items -- these contain all the data of interest
    *  to build_reference_to, but in INTERNAL mode we skip the construction
    *  of a reference, and instead return the data to the caller via the
@@ -255,6 +344,41 @@ private:
   std::list<dereference_callbackt::internal_item> internal_items;
   /** Flag for discarding all assertions encoded. */
   bool block_assertions;
+  /** Where dereference() results are reused from, if anywhere. */
+  memot *memo;
+  /** Where the dereference() being built records what it depends on. */
+  memo_entryt *recording;
+
+  /** Combine the references to the objects a pointer may point at into one
+   *  expression. Each case is a guard, true when the pointer points at its
+   *  object, and the reference to that object. Later cases take priority and
+   *  the first is the default when no guard holds, as in the chain
+   *    if g_n then v_n else ... if g_2 then v_2 else v_1
+   *  That chain is n deep though, and both the solver and the simplifier
+   *  recurse through it. Instead the cases are split in two halves: if one
+   *  of the later half's guards holds we pick from the later half, otherwise
+   *  from the earlier one. Each half's condition is the disjunction of the
+   *  conditions of its own halves, so the result has O(n) nodes and is
+   *  O(log n) deep.
+   *  @param cases The guard and reference of each object.
+   *  @param begin First case to combine.
+   *  @param end One past the last case to combine.
+   *  @param type Type of the references.
+   *  @param any_guard If not nullptr, set to an expression that holds when
+   *         any of the guards combined holds.
+   *  @return The combined expression. */
+  expr2tc make_case_split(
+    const std::vector<std::pair<expr2tc, expr2tc>> &cases,
+    std::size_t begin,
+    std::size_t end,
+    const type2tc &type,
+    expr2tc *any_guard) const;
+
+  /** Whether the liveness queries recorded in entry get the same answers. */
+  bool same_liveness(const memo_entryt &entry);
+
+  /** Ask the callback whether sym is live, recording the answer. */
+  bool is_live_variable(const expr2tc &sym);
 
   /** Interpret an expression that modifies the guard. i.e., an 'if' or a
    *  piece of logic that can be short-circuited.
@@ -26,6 +26,7 @@ Author: Daniel Kroening, kroening@kroening.com
 
 object_numberingt value_sett::object_numbering;
 object_number_numberingt value_sett::obj_numbering_refset;
+unsigned long value_sett::next_version = 0;
 
 void value_sett::output(std::ostream &out) const
 {
@@ -37,14 +38,14 @@ void value_sett::output(std::ostream &out) const
 
     const entryt &e = value.second;
 
-    if(has_prefix(e.identifier, "value_set::dynamic_object"))
+    if(has_prefix(id2string(e.identifier), "value_set::dynamic_object"))
     {
-      display_name = e.identifier + e.suffix;
+      display_name = id2string(e.identifier) + id2string(e.suffix);
       identifier = "";
     }
     else if(e.identifier == "value_set::return_value")
     {
-      display_name = "RETURN_VALUE" + e.suffix;
+      display_name = "RETURN_VALUE" + id2string(e.suffix);
       identifier = "";
     }
     else
@@ -54,8 +55,8 @@ void value_sett::output(std::ostream &out) const
       display_name=symbol.display_name()+e.suffix;
       identifier=symbol.name;
 #else
-      identifier = e.identifier;
-      display_name = identifier + e.suffix;
+      identifier = id2string(e.identifier);
+      display_name = identifier + id2string(e.suffix);
 #endif
     }
 
@@ -166,20 +167,58 @@ bool value_sett::make_union(const value_sett::valuest &new_values, bool keepnew)
       result = true;
   }
 
+  if(result)
+    bump_version();
+
   return result;
 }
 
 bool value_sett::make_union(object_mapt &dest, const object_mapt &src) const
 {
+  if(src.empty() || dest.shares_with(src))
+    return false;
+
+  if(dest.empty())
+  {
+    dest = src;
+    return true;
+  }
+
+  // Both maps are sorted by object number: walk them side by side, merging
+  // the records of objects that appear in both.
+  object_mapt::storet merged;
+  merged.reserve(dest.size() + src.size());
   bool result = false;
 
-  // Merge the pointed at objects in src into dest.
-  for(object_mapt::const_iterator it = src.begin(); it != src.end(); it++)
+  object_mapt::const_iterator d_it = dest.begin(), s_it = src.begin();
+  while(d_it != dest.end() && s_it != src.end())
   {
-    if(insert(dest, it))
+    if(d_it->first < s_it->first)
+      merged.push_back(*d_it++);
+    else if(s_it->first < d_it->first)
+    {
+      merged.push_back(*s_it++);
       result = true;
+    }
+    else
+    {
+      merged.push_back(*d_it++);
+      if(merge_offset(
+           merged.back().second, s_it->second, object_numbering[s_it->first]))
+        result = true;
+      s_it++;
+    }
   }
 
+  if(s_it != src.end())
+    result = true;
+  merged.insert(merged.end(), d_it, dest.end());
+  merged.insert(merged.end(), s_it, src.end());
+
+  // Keep sharing dest's records with its other copies if nothing changed
+  if(result)
+    dest.store = cowt<object_mapt::storet>(std::move(merged));
+
   return result;
 }
 
@@ -423,10 +462,10 @@ void value_sett::get_value_set_rec(
     assert(is_constant_int2t(dyn.instance));
     const constant_int2t &intref = to_constant_int2t(dyn.instance);
     std::string idnum = integer2string(intref.value);
-    const std::string name = "value_set::dynamic_object" + idnum + suffix;
+    const std::string name = "value_set::dynamic_object" + idnum;
 
     // look it up
-    valuest::const_iterator v_it = values.find(name);
+    valuest::const_iterator v_it = values.find(make_key(name, suffix));
 
     if(v_it != values.end())
     {
@@ -490,7 +529,8 @@ void value_sett::get_value_set_rec(
 
     // Look up this symbol, with the given suffix to distinguish any arrays or
     // members we've picked out of it at a higher level.
-    valuest::const_iterator v_it = values.find(sym.get_symbol_name() + suffix);
+    valuest::const_iterator v_it =
+      values.find(make_key(sym.get_symbol_name(), suffix));
 
     // If it points at things, put those things into the destination object map.
     if(v_it != values.end())
@@ -1103,7 +1143,10 @@ void value_sett::do_free(const expr2tc &op)
     }
 
     if(changed)
+    {
       value.second.object_map = new_object_map;
+      bump_version();
+    }
   }
 }
 
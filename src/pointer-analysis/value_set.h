@@ -9,13 +9,18 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_POINTER_ANALYSIS_VALUE_SET_H
 #define CPROVER_POINTER_ANALYSIS_VALUE_SET_H
 
+#include <algorithm>
+#include <cstdint>
 #include <pointer-analysis/value_sets.h>
 #include <set>
+#include <unordered_map>
+#include <util/cow.h>
 #include <util/irep2.h>
 #include <util/mp_arith.h>
 #include <util/namespace.h>
 #include <util/numbering.h>
 #include <util/type_byte_size.h>
+#include <vector>
 
 /** Code for tracking "value sets" across assignments in ESBMC.
  *
@@ -42,13 +47,14 @@ Author: Daniel Kroening, kroening@kroening.com
  *  as logic (elsewhere) for computing a fixedpoint, and some black magic that
  *  attempts to statically track dynamically allocated memory.
  *
- *  The only data element stored is a map from l1 variable names (as strings)
- *  to a record of what objects are stored. Data objects are numbered, with the
- *  mapping for that stored in a global variable, value_sett::object_numbering,
- *  (which will explode into multithreaded death cakes in the future). The
- *  primary interfaces to the value_sett object itself are the 'assign' method
- *  (for interpreting a variable assignment) and the get_value_set method, that
- *  takes a variable and returns the set of things it might point at.
+ *  The only data element stored is a map from l1 variable names (as interned
+ *  strings) to a record of what objects are stored. Data objects are
+ *  numbered, with the mapping for that stored in a global variable,
+ *  value_sett::object_numbering, (which will explode into multithreaded death
+ *  cakes in the future). The primary interfaces to the value_sett object
+ *  itself are the 'assign' method (for interpreting a variable assignment) and
+ *  the get_value_set method, that takes a variable and returns the set of
+ *  things it might point at.
  */
 
 typedef hash_numbering<expr2tc, irep2_hash> object_numberingt;
@@ -60,6 +66,7 @@ public:
   /** Primary constructor. Does approximately nothing non-standard. */
   value_sett(const namespacet &_ns)
     : location_number(0),
+      version(++next_version),
       ns(_ns),
       xchg_name("value_sett::__ESBMC_xchg_ptr"),
       xchg_num(0)
@@ -68,6 +75,7 @@ public:
 
   value_sett(const value_sett &ref)
     : location_number(ref.location_number),
+      version(ref.version),
       values(ref.values),
       ns(ref.ns),
       xchg_name("value_sett::__ESBMC_xchg_ptr"),
@@ -78,6 +86,7 @@ public:
   value_sett &operator=(const value_sett &ref)
   {
     location_number = ref.location_number;
+    version = ref.version;
     values = ref.values;
     xchg_name = ref.xchg_name;
     xchg_num = ref.xchg_num;
@@ -156,74 +165,104 @@ public:
   /** Datatype for a value set: stores a mapping between some integers and
    *  additional reference data in an objectt object. The integers are indexes
    *  into value_sett::object_numbering, which identifies the l1 variable
-   *  being referred to. */
-  typedef std::unordered_map<unsigned, objectt> object_mapt;
-  class object_map_dt
+   *  being referred to.
+   *
+   *  The records are kept in a vector sorted by object number, so that two
+   *  maps can be merged in one pass over both. The vector is shared between
+   *  copies of the map until one of them is modified: value sets are copied
+   *  every time symex forks a state, and most maps never change afterwards. */
+  class object_mapt
   {
-    // If you said this class looks pretty map like, it's because it used to be
-    // a subclass of std::map, which was far too funky for me, thanks.
   public:
-    ~object_map_dt()
+    typedef std::pair<unsigned, objectt> value_type;
+    typedef std::vector<value_type> storet;
+    typedef storet::const_iterator const_iterator;
+    typedef storet::iterator iterator;
+
+    const_iterator begin() const
     {
-      for(auto const &it : themap)
-        value_sett::obj_numbering_deref(it.first);
+      return store->begin();
     }
 
-    object_map_dt()
+    const_iterator end() const
     {
+      return store->end();
     }
 
-    object_map_dt(const object_map_dt &ref)
+    std::size_t size() const
     {
-      *this = ref;
-      for(auto const &it : themap)
-        value_sett::obj_numbering_ref(it.first);
+      return store->size();
     }
-    typedef object_mapt::const_iterator const_iterator;
-    typedef object_mapt::iterator iterator;
 
-    objectt &operator[](unsigned i)
+    bool empty() const
     {
-      if(themap.find(i) == themap.end())
-        value_sett::obj_numbering_ref(i);
-      return themap[i];
+      return store->empty();
     }
 
-    const_iterator find(unsigned i) const
+    void clear()
     {
-      return themap.find(i);
+      store = cowt<storet>();
     }
 
-    iterator find(unsigned i)
+    const_iterator find(unsigned n) const
     {
-      return themap.find(i);
+      const_iterator it = lower_bound(*store, n);
+      return (it != store->end() && it->first == n) ? it : store->end();
     }
 
-    const_iterator begin() const
+    /** Unshare the records and find the one for object n, if any. */
+    iterator find(unsigned n)
     {
-      return themap.begin();
+      storet &s = store.write();
+      iterator it = lower_bound(s, n);
+      return (it != s.end() && it->first == n) ? it : s.end();
     }
 
-    const_iterator end() const
+    /** Insert a record if there's none for its object yet.
+     *  @return The record for the object, and whether it was inserted. */
+    std::pair<iterator, bool> insert(const value_type &v)
+    {
+      storet &s = store.write();
+      // Maps are mostly built in object order
+      if(s.empty() || s.back().first < v.first)
+      {
+        s.push_back(v);
+        return std::make_pair(s.end() - 1, true);
+      }
+
+      iterator it = lower_bound(s, v.first);
+      if(it->first == v.first)
+        return std::make_pair(it, false);
+      return std::make_pair(s.insert(it, v), true);
+    }
+
+    /** Whether this and other share their records, and are thus equal. */
+    bool shares_with(const object_mapt &other) const
     {
-      return themap.end();
+      return store.shares_with(other.store);
     }
 
-    std::size_t size(void) const
+  protected:
+    template <class S>
+    static auto lower_bound(S &s, unsigned n) -> decltype(s.begin())
     {
-      return themap.size();
+      return std::lower_bound(
+        s.begin(), s.end(), n, [](const value_type &v, unsigned num) {
+          return v.first < num;
+        });
     }
 
-    object_mapt themap;
+    cowt<storet> store;
+
+    friend class value_sett;
   };
 
   /** Record for a particular value set: stores the identity of the variable
    *  that points at this set of objects, and the objects themselves (with
    *  associated offset data).
    *
-   *  The canonical name of this entry, stored in value_set::values, is the
-   *  'identifier' field concatonated with the 'suffix' field (see docs for
-   *  suffix).
+   *  An entry is identified by its 'identifier' field together with its
+   *  'suffix' field (see docs for suffix); see @ref keyt.
    */
   struct entryt
   {
@@ -232,7 +271,7 @@ public:
      *  can point at. */
     object_mapt object_map;
     /** The L1 name of the pointer variable that's doing the pointing. */
-    std::string identifier;
+    irep_idt identifier;
     /** Additional suffix data -- an L1 variable might actually contain several
      *  pointers. For example, an array of pointer, or a struct with multiple
      *  pointer members. This suffix uniquely distinguishes which pointer
@@ -240,20 +279,39 @@ public:
      *  it might read '.ptr' to identify the ptr field of a struct. It might
      *  also be '[]' if this is the value set of an array of pointers: we don't
      *  track each individual element, only the array of them. */
-    std::string suffix;
+    irep_idt suffix;
 
     entryt() = default;
 
-    entryt(std::string _identifier, const std::string &_suffix)
-      : identifier(std::move(_identifier)), suffix(_suffix)
+    entryt(const irep_idt &_identifier, const irep_idt &_suffix)
+      : identifier(_identifier), suffix(_suffix)
+    {
+    }
+  };
+
+  /** Key of an entry in @ref valuest: the string table numbers of its
+   *  identifier and suffix. Looking an entry up thus never has to build the
+   *  concatenation of the two. */
+  typedef std::pair<unsigned, unsigned> keyt;
+
+  static keyt make_key(const irep_idt &identifier, const irep_idt &suffix)
+  {
+    return keyt(identifier.get_no(), suffix.get_no());
+  }
+
+  struct key_hash
+  {
+    std::size_t operator()(const keyt &k) const
     {
+      return std::hash<uint64_t>()(
+        (static_cast<uint64_t>(k.first) << 32) | k.second);
     }
   };
 
   /** Type of the value-set containing structure. A hash map mapping variables
    *  to an entryt, storing the value set of objects a variable might point
    *  at. */
-  typedef std::unordered_map<irep_idt, entryt, irep_id_hash> valuest;
+  typedef std::unordered_map<keyt, entryt, key_hash> valuest;
 
   /** Get the natural alignment unit of a reference to e. I don't know a more
    *  appropriate term, but if we were to have an offset into e, then what is
@@ -319,8 +377,7 @@ public:
   void set(object_mapt &dest, object_mapt::const_iterator it) const
   {
     // Fetch/insert iterator
-    std::pair<object_mapt::iterator, bool> res =
-      dest.insert(object_mapt::value_type(it->first, it->second));
+    std::pair<object_mapt::iterator, bool> res = dest.insert(*it);
 
     // If element already existed, overwrite.
     if(res.second)
@@ -356,18 +413,35 @@ public:
    */
   bool insert(object_mapt &dest, unsigned n, const objectt &object) const
   {
-    object_mapt::const_iterator it = dest.find(n);
-    if(it == dest.end())
+    const object_mapt &cdest = dest;
+    object_mapt::const_iterator it = cdest.find(n);
+    if(it == cdest.end())
     {
       // new
       dest.insert(object_mapt::value_type(n, object));
       return true;
     }
 
-    object_mapt::iterator it2 = dest.find(n);
-    objectt &old = it2->second;
-    const expr2tc &expr_obj = object_numbering[n];
+    // Merge into a copy, so that dest is only unshared if it changes
+    objectt merged = it->second;
+    if(!merge_offset(merged, object, object_numbering[n]))
+      return false;
+
+    dest.find(n)->second = merged;
+    return true;
+  }
 
+  /** Merge the offset data of a second reference to the same object into
+   *  old. If the two offsets differ, old's offset becomes unknown, with the
+   *  alignment that both offsets guarantee.
+   *  @param old Offset data to merge into.
+   *  @param object Offset data of the other reference.
+   *  @param expr_obj The object referred to.
+   *  @return True if old was changed. */
+  bool
+  merge_offset(objectt &old, const objectt &object, const expr2tc &expr_obj)
+    const
+  {
     if(old.offset_is_set && object.offset_is_set)
     {
       if(old.offset == object.offset)
@@ -414,11 +488,14 @@ public:
   }
 
   /** Remove the given pointer value set from the map.
-   *  @param name The name of the variable, including suffix, to erase.
+   *  @param name The name of the variable, with no suffix, to erase.
    *  @return True when the erase succeeds, false otherwise. */
-  bool erase(const std::string &name)
+  bool erase(const irep_idt &name)
   {
-    return (values.erase(name) == 1);
+    if(values.erase(make_key(name, irep_idt())) == 0)
+      return false;
+    bump_version();
+    return true;
   }
 
   /** Get the set of things that an expression might point at. Interprets the
@@ -447,11 +524,12 @@ public:
   void clear()
   {
     values.clear();
+    bump_version();
   }
 
   /** Add a value set for the given variable name and suffix. No effect if the
    *  given record already exists. */
-  void add_var(const std::string &id, const std::string &suffix)
+  void add_var(const irep_idt &id, const irep_idt &suffix)
   {
     get_entry(id, suffix);
   }
@@ -462,26 +540,26 @@ public:
   }
 
   /** Delete the value set for the given variable name and suffix. */
-  void del_var(const std::string &id, const std::string &suffix)
+  void del_var(const irep_idt &id, const irep_idt &suffix)
   {
-    std::string index = id2string(id) + suffix;
-    values.erase(index);
+    if(values.erase(make_key(id, suffix)) != 0)
+      bump_version();
   }
 
   /** Look up the value set for the given variable name and suffix. */
-  entryt &get_entry(const std::string &id, const std::string &suffix)
+  entryt &get_entry(const irep_idt &id, const irep_idt &suffix)
   {
     return get_entry(entryt(id, suffix));
   }
 
   /** Look upt he value set for the variable name and suffix stored in the
-   *  given entryt. */
+   *  given entryt. The entry is taken to be modified by the caller. */
   entryt &get_entry(const entryt &e)
   {
-    std::string index = id2string(e.identifier) + e.suffix;
+    bump_version();
 
     std::pair<valuest::iterator, bool> r =
-      values.insert(std::pair<irep_idt, entryt>(index, e));
+      values.insert(valuest::value_type(make_key(e.identifier, e.suffix), e));
 
     return r.first->second;
   }
@@ -501,7 +579,8 @@ public:
   void dump() const;
 
   /** Join the two given object maps. Takes all the pointer records from src
-   *  and stores them into the dest object map.
+   *  and stores them into the dest object map, in a single merge of the two
+   *  sorted maps.
    *  @param dest Destination object map to join records into.
    *  @param src Object map to merge into dest.
    *  @return True when dest has been modified. */
@@ -646,17 +725,30 @@ protected:
   static void obj_numbering_ref(unsigned int num);
   static void obj_numbering_deref(unsigned int num);
 
+  /** Give this value set a version no other value set has had. */
+  void bump_version()
+  {
+    version = ++next_version;
+  }
+
+  static unsigned long next_version;
+
 public:
   //********************************** Members ***********************************
   /** Some crazy static analysis tool. */
   unsigned location_number;
+  /** Version of the contents of this value set. Every change gives it a new
+   *  version, unique across all value sets, so two value sets with the same
+   *  version hold the same values: they've been copied from one another
+   *  without being changed since. */
+  unsigned long version;
   /** Object to assign numbers to objects -- i.e., the numbers in the map of
    *  a @ref object_mapt. Static and bad. */
   static object_numberingt object_numbering;
   static object_number_numberingt obj_numbering_refset;
 
   /** Storage for all the value sets for all the variables in the program. See
-   *  @ref entryt for the format of the string used as an index. */
+   *  @ref keyt for what they're indexed by. */
   valuest values;
 
   /** Namespace for looking up types against. */
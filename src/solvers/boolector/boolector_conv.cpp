@@ -1,5 +1,6 @@
 #include <boolector_conv.h>
 #include <cstring>
+#include <util/config.h>
 
 #define new_ast new_solver_ast<btor_smt_ast>
 
@@ -36,6 +37,9 @@ boolector_convt::boolector_convt(bool int_encoding, const namespacet &ns)
   btor = boolector_new();
   boolector_set_opt(btor, BTOR_OPT_MODEL_GEN, 1);
   boolector_set_opt(btor, BTOR_OPT_AUTO_CLEANUP, 1);
+  // --multi-property calls the solver once per refuted claim
+  if(config.options.get_bool_option("multi-property"))
+    boolector_set_opt(btor, BTOR_OPT_INCREMENTAL, 1);
   boolector_set_abort(error_handler);
 }
 
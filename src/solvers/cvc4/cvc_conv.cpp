@@ -1,4 +1,5 @@
 #include <util/c_types.h>
+#include <util/config.h>
 #include <cvc_conv.h>
 
 #define new_ast new_solver_ast<cvc_smt_ast>
@@ -28,6 +29,9 @@ cvc_convt::cvc_convt(bool int_encoding, const namespacet &ns)
   // Already initialized stuff in the constructor list,
   smt.setOption("produce-models", true);
   smt.setOption("produce-assertions", true);
+  // --multi-property calls the solver once per refuted claim
+  if(config.options.get_bool_option("multi-property"))
+    smt.setOption("incremental", true);
 }
 
 smt_convt::resultt cvc_convt::dec_solve()
@@ -20,7 +20,8 @@ static inline bool array_indexes_are_same(
   return true;
 }
 
-array_convt::array_convt(smt_convt *_ctx) : array_iface(true, true), ctx(_ctx)
+array_convt::array_convt(smt_convt *_ctx, bool _lazy)
+  : array_iface(true, true), lazy(_lazy), ctx(_ctx)
 {
 }
 
@@ -519,6 +520,115 @@ void array_convt::add_array_constraints_for_solving()
   add_array_equalities();
 }
 
+bool array_convt::refine_array_model()
+{
+  if(!lazy)
+    return false;
+
+  // Model values of the indexes, looked up once each
+  std::map<smt_astt, BigInt> idx_values;
+  bool refined = false;
+
+  for(unsigned int arrid = 0; arrid < array_valuation.size(); arrid++)
+    refined |= refine_ackerman_constraints(arrid, idx_values);
+
+  for(auto &u : lazy_updates)
+  {
+    bool same = get_index_value(u.update_idx, idx_values) ==
+                get_index_value(u.idx, idx_values);
+    unsigned int &level = same ? u.eq_level : u.neq_level;
+    if(level != UINT_MAX || model_values_equal(u.dest, same ? u.val : u.src))
+      continue;
+
+    smt_astt idxeq = u.update_idx->eq(ctx, u.idx);
+    if(same)
+      ctx->assert_ast(ctx->mk_implies(idxeq, u.dest->eq(ctx, u.val)));
+    else
+      ctx->assert_ast(
+        ctx->mk_implies(ctx->mk_not(idxeq), u.dest->eq(ctx, u.src)));
+
+    level = ctx->ctx_level;
+    refined = true;
+  }
+
+  return refined;
+}
+
+bool array_convt::refine_ackerman_constraints(
+  unsigned int arrid,
+  std::map<smt_astt, BigInt> &idx_values)
+{
+  const index_map_containert &idx_map = expr_index_map[arrid];
+  if(array_valuation[arrid].empty() || idx_map.size() < 2)
+    return false;
+
+  const ast_vect &vals = array_valuation[arrid][0];
+
+  // Group the indexes by their value in the model. Only neighbours within a
+  // group are compared: once their values are equal, by transitivity every
+  // pair of indexes that are equal in the model has equal values.
+  std::map<BigInt, std::pair<unsigned int, smt_astt>> last_with_value;
+  bool refined = false;
+  for(auto const &it : idx_map)
+  {
+    smt_astt idx = ctx->convert_ast(it.idx);
+    auto res = last_with_value.emplace(
+      get_index_value(idx, idx_values), std::make_pair(it.vec_idx, idx));
+    if(res.second)
+      continue;
+
+    std::pair<unsigned int, smt_astt> prev = res.first->second;
+    res.first->second = std::make_pair(it.vec_idx, idx);
+
+    auto key = std::make_tuple(
+      arrid,
+      std::min(prev.first, it.vec_idx),
+      std::max(prev.first, it.vec_idx));
+    if(
+      model_values_equal(vals[prev.first], vals[it.vec_idx]) ||
+      !lazy_ackermans.emplace(key, ctx->ctx_level).second)
+      continue;
+
+    smt_astt idxeq = prev.second->eq(ctx, idx);
+    smt_astt valeq = vals[prev.first]->eq(ctx, vals[it.vec_idx]);
+    ctx->assert_ast(ctx->mk_implies(idxeq, valeq));
+    refined = true;
+  }
+
+  return refined;
+}
+
+bool array_convt::model_values_equal(smt_astt a, smt_astt b)
+{
+  if(a == b)
+    return true;
+
+  // Values of other sorts can't be read back here: take them to differ, so
+  // the constraint is asserted anyway.
+  switch(a->sort->id)
+  {
+  case SMT_SORT_BOOL:
+    return ctx->get_bool(a) == ctx->get_bool(b);
+  case SMT_SORT_BV:
+  case SMT_SORT_FIXEDBV:
+  case SMT_SORT_BVFP:
+    return ctx->get_bv(a) == ctx->get_bv(b);
+  default:
+    return false;
+  }
+}
+
+const BigInt &array_convt::get_index_value(
+  smt_astt idx,
+  std::map<smt_astt, BigInt> &idx_values)
+{
+  auto it = idx_values.find(idx);
+  if(it == idx_values.end())
+    it = idx_values.emplace(idx, ctx->get_bv(idx)).first;
+
+  return it->second;
+}
+
 void array_convt::push_array_ctx()
 {
   // The most important factor in this process is to make sure that new indexes
@@ -610,6 +720,33 @@ void array_convt::pop_array_ctx()
     ctx_level_idx.erase(target_ctx);
   }
 
+  // Forget the lazy constraints recorded in the old context, and those that
+  // were asserted in it, as the solver has just dropped them.
+  lazy_updates.erase(
+    std::remove_if(
+      lazy_updates.begin(),
+      lazy_updates.end(),
+      [target_ctx](const lazy_update &u) {
+        return u.ctx_level == target_ctx;
+      }),
+    lazy_updates.end());
+
+  for(auto &u : lazy_updates)
+  {
+    if(u.eq_level == target_ctx)
+      u.eq_level = UINT_MAX;
+    if(u.neq_level == target_ctx)
+      u.neq_level = UINT_MAX;
+  }
+
+  for(auto it = lazy_ackermans.begin(); it != lazy_ackermans.end();)
+  {
+    if(it->second == target_ctx)
+      it = lazy_ackermans.erase(it);
+    else
+      ++it;
+  }
+
   // And now, in an intensely expensive operation, resize all the array value
   // vectors if they've had a change in number of indexes.
   for(unsigned int arrid = 0; arrid < array_updates.size(); arrid++)
@@ -1137,6 +1274,22 @@ void array_convt::execute_array_update(
     if(it2.vec_idx < start_point)
       continue;
 
+    // Lazily, this is left for refine_array_model to assert
+    if(lazy)
+    {
+      lazy_update u;
+      u.dest = dest_data[it2.vec_idx];
+      u.src = source_data[it2.vec_idx];
+      u.val = updated_value;
+      u.update_idx = update_idx_ast;
+      u.idx = ctx->convert_ast(it2.idx);
+      u.ctx_level = ctx->ctx_level;
+      u.eq_level = UINT_MAX;
+      u.neq_level = UINT_MAX;
+      lazy_updates.push_back(u);
+      continue;
+    }
+
     // Generate an ITE. If the index is nondeterministically equal to the
     // current index, take the updated value, otherwise the original value.
     // This departs from the CBMC implementation, in that they explicitly
@@ -1291,6 +1444,10 @@ void array_convt::add_initial_ackerman_constraints(
   // Add ackerman constraints: these state that for each element of an array,
   // where the indexes are equivalent (in the solver), then the value of the
   // elements are equivalent. The cost is quadratic, alas.
+  // Lazily, only the ones a model violates get asserted, by
+  // refine_ackerman_constraints.
+  if(lazy)
+    return;
 
   for(auto const &it : idx_map)
   {
@@ -16,8 +16,10 @@
 //
 // As a result, this particular class is due some serious maintenence.
 
+#include <map>
 #include <set>
 #include <solvers/smt/smt_conv.h>
+#include <tuple>
 #include <util/irep2.h>
 
 static inline bool is_unbounded_array(const smt_sort *s)
@@ -114,7 +116,7 @@ public:
         std::greater<unsigned int>>>>
     index_map_containert;
 
-  array_convt(smt_convt *_ctx);
+  array_convt(smt_convt *_ctx, bool _lazy = false);
   ~array_convt() = default;
 
   // Public api
@@ -127,6 +129,7 @@ public:
   smt_astt
   convert_array_of(smt_astt init_val, unsigned long domain_width) override;
   void add_array_constraints_for_solving() override;
+  bool refine_array_model() override;
 
   // Heavy lifters
   virtual smt_astt convert_array_of_wsort(
@@ -222,6 +225,12 @@ public:
     const ast_vect &vals,
     const index_map_containert &idx_map,
     unsigned int start_point);
+  bool refine_ackerman_constraints(
+    unsigned int arrid,
+    std::map<smt_astt, BigInt> &idx_values);
+  bool model_values_equal(smt_astt a, smt_astt b);
+  const BigInt &
+  get_index_value(smt_astt idx, std::map<smt_astt, BigInt> &idx_values);
   void add_new_indexes();
   void execute_new_updates();
   void apply_new_selects();
@@ -436,6 +445,35 @@ public:
   // In reverse, these correspond to ast_vect and array_update_vect
   std::vector<std::vector<std::vector<smt_astt>>> array_valuation;
 
+  // Lazy constraints. Rather than asserting the Ackerman constraints between
+  // every pair of indexes, and an update constraint for every index of every
+  // update, both of which are quadratic in the number of indexes, only the
+  // instances that a model found by the solver violates are asserted, by
+  // refine_array_model. Nothing is left out unless lazy is set.
+  bool lazy;
+
+  // An update constraint left out: dest == ite(update_idx == idx, val, src).
+  // If a model violates it, the half matching whether the indexes are equal
+  // in that model is asserted; the levels record the context each half was
+  // asserted in, or UINT_MAX if it has not been.
+  struct lazy_update
+  {
+    smt_astt dest;
+    smt_astt src;
+    smt_astt val;
+    smt_astt update_idx;
+    smt_astt idx;
+    unsigned int ctx_level;
+    unsigned int eq_level;
+    unsigned int neq_level;
+  };
+  std::vector<lazy_update> lazy_updates;
+
+  // Ackerman constraints asserted so far, as (array id, vector index, vector
+  // index), with the context level each was asserted in.
+  std::map<std::tuple<unsigned int, unsigned int, unsigned int>, unsigned int>
+    lazy_ackermans;
+
   smt_convt *ctx;
 };
 
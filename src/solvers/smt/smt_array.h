@@ -54,6 +54,16 @@ public:
   virtual void push_array_ctx(){};
   virtual void pop_array_ctx(){};
 
+  /** Check the model of the last satisfiable dec_solve against any array
+   *  axioms that were left out of the formula, asserting the ones it
+   *  violates.
+   *  @return True if anything was asserted, i.e. the formula must be solved
+   *          again before the model can be trusted. */
+  virtual bool refine_array_model()
+  {
+    return false;
+  }
+
   // And everything else goes through the ast methods!
 
   // Small piece of internal munging:
@@ -2016,6 +2016,15 @@ void smt_convt::pre_solve()
   array_api->add_array_constraints_for_solving();
 }
 
+smt_convt::resultt smt_convt::solve_with_refinement()
+{
+  resultt res = dec_solve();
+  while(res == P_SATISFIABLE && array_api->refine_array_model())
+    res = dec_solve();
+
+  return res;
+}
+
 expr2tc smt_convt::get(const expr2tc &expr)
 {
   if(is_constant_number(expr))
@@ -245,6 +245,12 @@ public:
    *  @return Result code of the call to the solver. */
   virtual resultt dec_solve() = 0;
 
+  /** Solve the formula with dec_solve, then let the array api refine the
+   *  model for as long as it has axioms left to add, solving again after
+   *  each round. Without lazy array constraints this is just dec_solve.
+   *  @return Result code of the last call to the solver. */
+  resultt solve_with_refinement();
+
   void pre_solve();
 
   /** Get the satisfying assignment using the type.
@@ -110,7 +110,10 @@ smt_convt *create_new_smtlib_solver(
 }
 
 smtlib_convt::smtlib_convt(bool int_encoding, const namespacet &_ns)
-  : smt_convt(int_encoding, _ns), array_iface(false, false), fp_convt(this)
+  : smt_convt(int_encoding, _ns),
+    array_iface(false, false),
+    fp_convt(this),
+    model_fetched(false)
 {
   temp_sym_count.push_back(1);
   std::string cmd;
@@ -135,6 +138,7 @@ smtlib_convt::smtlib_convt(bool int_encoding, const namespacet &_ns)
       std::cerr << "Failed to open \"" << cmd << "\"" << std::endl;
       abort();
     }
+    setvbuf(out_stream, nullptr, _IOFBF, 1 << 20);
 
     in_stream = nullptr;
     solver_name = "Text output";
@@ -195,6 +199,7 @@ smtlib_convt::smtlib_convt(bool int_encoding, const namespacet &_ns)
     close(outpipe[0]);
     close(inpipe[1]);
     out_stream = fdopen(outpipe[1], "w");
+    setvbuf(out_stream, nullptr, _IOFBF, 1 << 20);
     in_stream = fdopen(inpipe[0], "r");
   }
 
@@ -366,6 +371,14 @@ smtlib_convt::emit_ast(const smtlib_smt_ast *ast, std::string &output)
     // Continue.
   }
 
+  // Already bound by define_ast
+  defined_astst::iterator def = defined_asts.find(ast);
+  if(def != defined_asts.end())
+  {
+    output = def->name;
+    return 0;
+  }
+
   for(auto i = 0; i < ast->args.size(); i++)
     brace_level +=
       emit_ast(static_cast<const smtlib_smt_ast *>(ast->args[i]), args[i]);
@@ -381,17 +394,7 @@ smtlib_convt::emit_ast(const smtlib_smt_ast *ast, std::string &output)
   fprintf(out_stream, "(let ((%s (", tempname.c_str());
 
   // This asts function
-  assert(static_cast<int>(ast->kind) <= static_cast<int>(expr2t::end_expr_id));
-  if(ast->kind == SMT_FUNC_EXTRACT)
-  {
-    // Extract is an indexed function
-    fprintf(
-      out_stream, "(_ extract %d %d)", ast->extract_high, ast->extract_low);
-  }
-  else
-  {
-    fprintf(out_stream, "%s", smt_func_name_table[ast->kind].c_str());
-  }
+  fprintf(out_stream, "%s", func_name(ast).c_str());
 
   // Its operands
   for(auto i = 0; i < ast->args.size(); i++)
@@ -405,6 +408,89 @@ smtlib_convt::emit_ast(const smtlib_smt_ast *ast, std::string &output)
   return brace_level + 1;
 }
 
+std::string smtlib_convt::func_name(const smtlib_smt_ast *ast) const
+{
+  assert(static_cast<int>(ast->kind) <= static_cast<int>(expr2t::end_expr_id));
+  if(ast->kind == SMT_FUNC_EXTRACT)
+  {
+    // Extract is an indexed function
+    std::stringstream ss;
+    ss << "(_ extract " << ast->extract_high << " " << ast->extract_low << ")";
+    return ss.str();
+  }
+
+  return smt_func_name_table[ast->kind];
+}
+
+std::string smtlib_convt::define_ast(const smtlib_smt_ast *ast)
+{
+  // Terminals are printed in place; anything else is referred to by the name
+  // of its define-fun once it has one.
+  auto name_of = [this](const smtlib_smt_ast *a) {
+    std::string name;
+    defined_astst::iterator def = defined_asts.find(a);
+    if(def != defined_asts.end())
+      name = def->name;
+    else
+      emit_terminal_ast(a, name);
+    return name;
+  };
+
+  auto is_bound = [this](const smtlib_smt_ast *a) {
+    switch(a->kind)
+    {
+    case SMT_FUNC_INT:
+    case SMT_FUNC_BOOL:
+    case SMT_FUNC_BVINT:
+    case SMT_FUNC_REAL:
+    case SMT_FUNC_SYMBOL:
+      return true;
+    default:
+      return defined_asts.find(a) != defined_asts.end();
+    }
+  };
+
+  // Walk the DAG operands first without recursing, as the formulae can be
+  // far deeper than the stack. The definitions of one assertion are gathered
+  // and written out in one go.
+  std::string text;
+  std::vector<std::pair<const smtlib_smt_ast *, bool>> stack;
+  stack.emplace_back(ast, false);
+  while(!stack.empty())
+  {
+    const smtlib_smt_ast *node = stack.back().first;
+    bool operands_done = stack.back().second;
+    stack.pop_back();
+
+    if(is_bound(node))
+      continue;
+
+    if(!operands_done)
+    {
+      stack.emplace_back(node, true);
+      for(auto it = node->args.rbegin(); it != node->args.rend(); it++)
+        stack.emplace_back(static_cast<const smtlib_smt_ast *>(*it), false);
+      continue;
+    }
+
+    std::stringstream ss;
+    ss << "?x" << temp_sym_count.back()++;
+    std::string name = ss.str();
+
+    text += "(define-fun " + name + " () " + sort_to_string(node->sort) + " (";
+    text += func_name(node);
+    for(smt_astt arg : node->args)
+      text += " " + name_of(static_cast<const smtlib_smt_ast *>(arg));
+    text += "))\n";
+
+    defined_ast_rec record = {node, name, ctx_level};
+    defined_asts.insert(record);
+  }
+
+  fwrite(text.data(), 1, text.size(), out_stream);
+  return name_of(ast);
+}
+
 smt_convt::resultt smtlib_convt::dec_solve()
 {
   pre_solve();
@@ -416,6 +502,10 @@ smt_convt::resultt smtlib_convt::dec_solve()
 
   fprintf(out_stream, "(check-sat)\n");
 
+  // Any model we fetched before is now stale
+  model_values.clear();
+  model_fetched = false;
+
   // Flush out command, starting model check
   fflush(out_stream);
 
@@ -450,6 +540,82 @@ smt_convt::resultt smtlib_convt::dec_solve()
   }
 }
 
+static BigInt integer_value(const sexpr &respval)
+{
+  // Attempt to read an integer.
+  BigInt m;
+  if(respval.token == TOK_DECIMAL)
+  {
+    m = string2integer(respval.data);
+  }
+  else if(respval.token == TOK_NUMERAL)
+  {
+    std::cerr << "Numeral value for integer symbol from smtlib solver"
+              << std::endl;
+    abort();
+  }
+  else if(respval.token == TOK_HEXNUM)
+  {
+    std::string data = respval.data.substr(2);
+    m = string2integer(data, 16);
+  }
+  else if(respval.token == TOK_BINNUM)
+  {
+    std::string data = respval.data.substr(2);
+    m = string2integer(data, 2);
+  }
+
+  return m;
+}
+
+void smtlib_convt::fetch_model()
+{
+  if(model_fetched)
+    return;
+  model_fetched = true;
+
+  // Arrays are fetched element by element, and reals come back as terms we
+  // can't parse; everything else is asked for at once.
+  std::string names;
+  for(const auto &sym : symbol_table)
+  {
+    smt_sort_kind id = sym.sort->id;
+    if(
+      id == SMT_SORT_BV || id == SMT_SORT_FIXEDBV || id == SMT_SORT_INT ||
+      id == SMT_SORT_BOOL)
+      names += " |" + sym.ident + "|";
+  }
+
+  if(names.empty())
+    return;
+
+  fprintf(out_stream, "(get-value (%s))\n", names.c_str() + 1);
+  fflush(out_stream);
+  smtlib_send_start_code = 1;
+  smtlibparse(TOK_START_VALUE);
+
+  if(smtlib_output->token != 0)
+  {
+    // Leave the cache empty: the values will be asked for one at a time.
+    delete smtlib_output;
+    return;
+  }
+
+  for(sexpr &pair : smtlib_output->sexpr_list)
+  {
+    assert(
+      pair.sexpr_list.size() == 2 &&
+      "Expected 2 operands in "
+      "valuation_pair_list from smtlib solver");
+    sexpr &symname = pair.sexpr_list.front();
+    if(symname.token != TOK_SIMPLESYM)
+      continue;
+    model_values[symname.data] = std::move(pair.sexpr_list.back());
+  }
+
+  delete smtlib_output;
+}
+
 BigInt smtlib_convt::get_bv(smt_astt a)
 {
   // This should always be a symbol.
@@ -457,6 +623,11 @@ BigInt smtlib_convt::get_bv(smt_astt a)
   assert(sa->kind == SMT_FUNC_SYMBOL && "Non-symbol in smtlib expr get_bv()");
   std::string name = sa->symname;
 
+  fetch_model();
+  auto cached = model_values.find(name);
+  if(cached != model_values.end())
+    return integer_value(cached->second);
+
   fprintf(out_stream, "(get-value (|%s|))\n", name.c_str());
   fflush(out_stream);
   smtlib_send_start_code = 1;
@@ -494,28 +665,7 @@ BigInt smtlib_convt::get_bv(smt_astt a)
     abort();
   }
 
-  // Attempt to read an integer.
-  BigInt m;
-  if(respval.token == TOK_DECIMAL)
-  {
-    m = string2integer(respval.data);
-  }
-  else if(respval.token == TOK_NUMERAL)
-  {
-    std::cerr << "Numeral value for integer symbol from smtlib solver"
-              << std::endl;
-    abort();
-  }
-  else if(respval.token == TOK_HEXNUM)
-  {
-    std::string data = respval.data.substr(2);
-    m = string2integer(data, 16);
-  }
-  else if(respval.token == TOK_BINNUM)
-  {
-    std::string data = respval.data.substr(2);
-    m = string2integer(data, 2);
-  }
+  BigInt m = integer_value(respval);
 
   delete smtlib_output;
   return m;
@@ -672,6 +822,21 @@ smtlib_convt::get_array_elem(smt_astt array, uint64_t index, const type2tc &t)
 
 bool smtlib_convt::get_bool(smt_astt a)
 {
+  const smtlib_smt_ast *sa = static_cast<const smtlib_smt_ast *>(a);
+  if(sa->kind == SMT_FUNC_SYMBOL)
+  {
+    fetch_model();
+    auto cached = model_values.find(sa->symname);
+    if(cached != model_values.end())
+    {
+      if(cached->second.token == TOK_KW_TRUE)
+        return true;
+      if(cached->second.token == TOK_KW_FALSE)
+        return false;
+      abort();
+    }
+  }
+
   fprintf(out_stream, "(get-value (");
 
   std::string output;
@@ -747,26 +912,11 @@ void smtlib_convt::assert_ast(smt_astt a)
 {
   const smtlib_smt_ast *sa = static_cast<const smtlib_smt_ast *>(a);
 
-  // Encode an assertion
-  fprintf(out_stream, "(assert\n");
-
-  // The algorithm: descend through the AST operands, binding values to
-  // temporary symbols, then emit functions on those temporary symbols.
-  // All recursively. The non-trivial bit is tracking how many ending
-  // braces are required.
-  // This is inspired by the output from Z3 that I've seen.
-  std::string output;
-  unsigned int brace_level = emit_ast(sa, output);
-
-  // Emit the final temporary symbol - this is what gets asserted.
-  fprintf(out_stream, "%s", output.c_str());
-
-  // Emit a ton of end braces.
-  for(unsigned int i = 0; i < brace_level; i++)
-    fputc(')', out_stream);
-
-  // Final brace for closing the 'assert'.
-  fprintf(out_stream, ")\n");
+  // Bind each subterm not seen by an earlier assertion to a name of its own,
+  // then assert the name of the whole. Terms shared between assertions are
+  // thus printed once, keeping the output linear in the size of the DAG.
+  std::string output = define_ast(sa);
+  fprintf(out_stream, "(assert %s)\n", output.c_str());
 }
 
 smt_astt smtlib_convt::mk_smt_int(const BigInt &theint)
@@ -913,6 +1063,8 @@ void smtlib_convt::push_ctx()
   temp_sym_count.push_back(temp_sym_count.back());
 
   fprintf(out_stream, "(push 1)\n");
+  model_values.clear();
+  model_fetched = false;
 }
 
 smt_astt smtlib_convt::mk_add(smt_astt a, smt_astt b)
@@ -1413,6 +1565,12 @@ smt_astt smtlib_convt::mk_isint(smt_astt a)
 void smtlib_convt::pop_ctx()
 {
   fprintf(out_stream, "(pop 1)\n");
+  model_values.clear();
+  model_fetched = false;
+
+  // The definitions made at this level are gone with it
+  defined_astst::nth_index<1>::type &defs_numindex = defined_asts.get<1>();
+  defs_numindex.erase(ctx_level);
 
   // Wipe this level of symbol table.
   symbol_tablet::nth_index<1>::type &syms_numindex = symbol_table.get<1>();
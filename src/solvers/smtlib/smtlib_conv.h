@@ -5,6 +5,7 @@
 #include <solvers/smt/smt_conv.h>
 #include <string>
 #include <unistd.h>
+#include <unordered_map>
 #include <util/irep2.h>
 
 /** Identifiers for SMT functions.
@@ -262,10 +263,25 @@ public:
   expr2tc
   get_array_elem(smt_astt array, uint64_t index, const type2tc &type) override;
 
+  /** Fetch the values of all declared scalar symbols with a single get-value
+   *  command, so that building a trace doesn't need one round trip to the
+   *  solver per symbol. Does nothing if the model has already been fetched
+   *  since the last check-sat. */
+  void fetch_model();
+
   std::string sort_to_string(const smt_sort *s) const;
   unsigned int emit_terminal_ast(const smtlib_smt_ast *a, std::string &output);
   unsigned int emit_ast(const smtlib_smt_ast *ast, std::string &output);
 
+  /** Bind every subterm of ast that hasn't been bound yet to a name with a
+   *  define-fun, operands first, so that each distinct smt_ast is printed
+   *  once however many assertions share it.
+   *  @return The name of ast, or its text if it is a terminal. */
+  std::string define_ast(const smtlib_smt_ast *ast);
+
+  /** The operator of a non-terminal AST, as applied in SMT-LIB text */
+  std::string func_name(const smtlib_smt_ast *ast) const;
+
   void push_ctx() override;
   void pop_ctx() override;
 
@@ -298,6 +314,31 @@ public:
 
   symbol_tablet symbol_table;
   std::vector<unsigned long> temp_sym_count;
+
+  /** Names bound to ASTs by define_ast, and the context level each binding
+   *  was made in so that it can be forgotten when that level is popped. */
+  struct defined_ast_rec
+  {
+    const smt_ast *ast;
+    std::string name;
+    unsigned int level;
+  };
+
+  typedef boost::multi_index_container<
+    defined_ast_rec,
+    boost::multi_index::indexed_by<
+      boost::multi_index::hashed_unique<
+        BOOST_MULTI_INDEX_MEMBER(defined_ast_rec, const smt_ast *, ast)>,
+      boost::multi_index::ordered_non_unique<
+        BOOST_MULTI_INDEX_MEMBER(defined_ast_rec, unsigned int, level),
+        std::greater<unsigned int>>>>
+    defined_astst;
+
+  defined_astst defined_asts;
+
+  /** Values of the symbols in the current model, by symbol name */
+  std::unordered_map<std::string, sexpr> model_values;
+  bool model_fetched;
   static const std::string temp_prefix;
 
   /** Mapping of SMT function IDs to their names. XXX, incorrect size. */
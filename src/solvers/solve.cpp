@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <solve.h>
 #include <solver_config.h>
 #include <solvers/smt/array_conv.h>
@@ -156,6 +157,10 @@ smt_convt *create_solver_factory(
   bool sym_flat = options.get_bool_option("tuple-sym-flattener");
   bool array_flat = options.get_bool_option("array-flattener");
   bool fp_to_bv = options.get_bool_option("fp2bv");
+  // Lazy array constraints read index and element values of arbitrary ASTs
+  // from the model as bitvectors, which smtlib can only do for symbols
+  bool lazy_arrays = options.get_bool_option("lazy-array-constraints") &&
+                     !int_encoding && solver_name != "smtlib";
 
   // Pick a tuple flattener to use. If the solver has native support, and no
   // options were given, use that by default
@@ -177,9 +182,9 @@ smt_convt *create_solver_factory(
   if(array_api != nullptr && !array_flat)
     ctx->set_array_iface(array_api);
   else if(array_flat)
-    ctx->set_array_iface(new array_convt(ctx));
+    ctx->set_array_iface(new array_convt(ctx, lazy_arrays));
   else
-    ctx->set_array_iface(new array_convt(ctx));
+    ctx->set_array_iface(new array_convt(ctx, lazy_arrays));
 
   if(fp_api == nullptr || fp_to_bv)
     ctx->set_fp_conv(new fp_convt(ctx));
@@ -189,3 +194,51 @@ smt_convt *create_solver_factory(
   ctx->smt_post_init();
   return ctx;
 }
+
+std::vector<std::string> portfolio_solvers(const optionst &options)
+{
+  std::vector<std::string> solvers;
+  std::string list = options.get_option("portfolio-solvers");
+
+  if(list.empty())
+  {
+    for(const auto &esbmc_solver : esbmc_solvers)
+      if(esbmc_solver.name != "smtlib")
+        solvers.push_back(esbmc_solver.name);
+    return solvers;
+  }
+
+  std::string::size_type start = 0;
+  while(start <= list.size())
+  {
+    std::string::size_type end = list.find(',', start);
+    if(end == std::string::npos)
+      end = list.size();
+
+    std::string name = list.substr(start, end - start);
+    start = end + 1;
+
+    // Skip empty entries, and don't race a solver against itself
+    if(
+      name.empty() ||
+      std::find(solvers.begin(), solvers.end(), name) != solvers.end())
+      continue;
+
+    bool found = false;
+    for(const auto &esbmc_solver : esbmc_solvers)
+      found |= (name == esbmc_solver.name);
+
+    if(!found)
+    {
+      std::cerr << "The " << name
+                << " solver has not been built into this version of ESBMC, "
+                   "sorry"
+                << std::endl;
+      abort();
+    }
+
+    solvers.push_back(name);
+  }
+
+  return solvers;
+}
@@ -5,6 +5,7 @@
 #include <string>
 #include <util/config.h>
 #include <util/namespace.h>
+#include <vector>
 
 typedef smt_convt *(solver_creator)(
   bool int_encoding,
@@ -35,4 +36,8 @@ smt_convt *create_solver_factory(
   const namespacet &ns,
   const optionst &options);
 
+/** Names of the solvers --portfolio races: those listed in the comma
+ *  separated --portfolio-solvers, or every solver built in but smtlib. */
+std::vector<std::string> portfolio_solvers(const optionst &options);
+
 #endif
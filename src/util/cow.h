@@ -0,0 +1,66 @@
+/*******************************************************************\
+
+Module: Copy-on-write values
+
+\*******************************************************************/
+
+#ifndef CPROVER_COW_H
+#define CPROVER_COW_H
+
+#include <memory>
+#include <utility>
+
+/** A value shared between copies until one of them writes to it. Copying a
+ *  cowt only copies a pointer; write() takes a private copy of the value
+ *  first if anyone else still refers to it. Reading never copies, so reads
+ *  should go through a const cowt (or operator-> on one) wherever possible. */
+template <class T>
+class cowt
+{
+public:
+  cowt() : ptr(std::make_shared<T>())
+  {
+  }
+
+  explicit cowt(const T &val) : ptr(std::make_shared<T>(val))
+  {
+  }
+
+  explicit cowt(T &&val) : ptr(std::make_shared<T>(std::move(val)))
+  {
+  }
+
+  const T &operator*() const
+  {
+    return *ptr;
+  }
+
+  const T *operator->() const
+  {
+    return ptr.get();
+  }
+
+  /** Value to modify, no longer shared with any other cowt */
+  T &write()
+  {
+    if(ptr.use_count() != 1)
+      ptr = std::make_shared<T>(*ptr);
+    return *ptr;
+  }
+
+  bool shared() const
+  {
+    return ptr.use_count() != 1;
+  }
+
+  /** True if this and other refer to the very same value */
+  bool shares_with(const cowt &other) const
+  {
+    return ptr == other.ptr;
+  }
+
+private:
+  std::shared_ptr<T> ptr;
+};
+
+#endif
@@ -0,0 +1,37 @@
+/*******************************************************************\
+
+Module: Hash-consing of expressions
+
+\*******************************************************************/
+
+#include <util/expr_intern.h>
+
+expr2tc expr_intern_tablet::intern(const expr2tc &expr)
+{
+  if(is_nil_expr(expr) || members.count(expr.get()) != 0)
+    return expr;
+
+  // Operands first, so that the node we keep only points at table nodes
+  std::vector<expr2tc> ops;
+  bool changed = false;
+  expr->foreach_operand([this, &ops, &changed](const expr2tc &e) {
+    ops.push_back(intern(e));
+    changed |= ops.back().get() != e.get();
+  });
+
+  expr2tc node = expr;
+  if(changed)
+  {
+    // Detaches a copy: someone else may still hold the original
+    std::vector<expr2tc>::const_iterator it = ops.begin();
+    node.get()->Foreach_operand([&it](expr2tc &e) { e = *it++; });
+  }
+
+  auto res = table.insert(node);
+  if(res.second)
+    members.insert(res.first->get());
+  else
+    ++num_merged;
+
+  return *res.first;
+}
@@ -0,0 +1,53 @@
+/*******************************************************************\
+
+Module: Hash-consing of expressions
+
+\*******************************************************************/
+
+#ifndef CPROVER_EXPR_INTERN_H
+#define CPROVER_EXPR_INTERN_H
+
+#include <unordered_set>
+#include <util/irep2.h>
+
+/** Table of unique expressions.
+ *  intern() returns the table's node for an expression, made of the table's
+ *  nodes for its operands, so that all the structurally equal (sub)expressions
+ *  interned in one table are the same node. Comparing those is then a pointer
+ *  comparison, and each one is only stored once.
+ *
+ *  The table holds a reference to each of its nodes, so a holder that wants to
+ *  modify one detaches a copy first and the table's node never changes. All of
+ *  them are released together when the table is cleared or destroyed. */
+class expr_intern_tablet
+{
+public:
+  expr2tc intern(const expr2tc &expr);
+
+  void clear()
+  {
+    table.clear();
+    members.clear();
+    num_merged = 0;
+  }
+
+  /** Number of unique nodes in the table */
+  std::size_t size() const
+  {
+    return table.size();
+  }
+
+  /** Number of nodes that intern() replaced with an equal one in the table */
+  std::size_t merged() const
+  {
+    return num_merged;
+  }
+
+protected:
+  std::unordered_set<expr2tc, irep2_hash> table;
+  /** The nodes of table, to skip subexpressions that are interned already */
+  std::unordered_set<const expr2t *> members;
+  std::size_t num_merged = 0;
+};
+
+#endif
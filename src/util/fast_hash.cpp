@@ -0,0 +1,133 @@
+/*******************************************************************\
+
+Module: Fast non-cryptographic 128-bit hashing
+
+\*******************************************************************/
+
+#include <cstring>
+#include <util/fast_hash.h>
+
+// Odd constants from xxh3's secret and primes
+static const uint64_t prime64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t prime64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t secret_1 = 0xbe4ba423396cfeb8ULL;
+static const uint64_t secret_2 = 0x1cad21f72c81017cULL;
+
+/** Multiply into 128 bits and fold the halves together */
+static inline uint64_t mul128_fold64(uint64_t a, uint64_t b)
+{
+  __uint128_t product = (__uint128_t)a * b;
+  return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+static inline uint64_t avalanche(uint64_t h)
+{
+  h ^= h >> 37;
+  h *= prime64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+fast_hash::fast_hash() : hash{prime64_1, prime64_2}
+{
+}
+
+void fast_hash::ingest(uint64_t val)
+{
+  hash[0] = mul128_fold64(hash[0] ^ val ^ secret_1, prime64_1 ^ secret_2);
+  hash[1] = mul128_fold64(hash[1] ^ val ^ secret_2, prime64_2 ^ secret_1);
+}
+
+void fast_hash::ingest(void const *data, unsigned int size)
+{
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+
+  for(; size >= sizeof(uint64_t); size -= sizeof(uint64_t))
+  {
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+    ingest(word);
+    bytes += sizeof(word);
+  }
+
+  // Pad the tail and tag it with its length, so that "a" and "a\0" differ
+  uint64_t word = 0;
+  memcpy(&word, bytes, size);
+  ingest(word ^ ((uint64_t)size << 56));
+}
+
+void fast_hash::fin()
+{
+  uint64_t lo = avalanche(hash[0] + hash[1] * prime64_1);
+  uint64_t hi = avalanche(hash[1] ^ mul128_fold64(hash[0], prime64_2));
+  hash[0] = lo;
+  hash[1] = hi;
+}
+
+fast_hash_sett::fast_hash_sett() : slots(64), num_elems(0), has_zero(false)
+{
+  for(auto &it : slots)
+    it.hash[0] = it.hash[1] = 0;
+}
+
+static inline bool is_empty_slot(const fast_hash &h)
+{
+  return h.hash[0] == 0 && h.hash[1] == 0;
+}
+
+std::size_t fast_hash_sett::find_slot(const fast_hash &h) const
+{
+  // slots.size() is a power of two
+  std::size_t mask = slots.size() - 1;
+  std::size_t idx = h.hash[0] & mask;
+  while(!is_empty_slot(slots[idx]) && !(slots[idx] == h))
+    idx = (idx + 1) & mask;
+
+  return idx;
+}
+
+bool fast_hash_sett::contains(const fast_hash &h) const
+{
+  if(is_empty_slot(h))
+    return has_zero;
+
+  return !is_empty_slot(slots[find_slot(h)]);
+}
+
+bool fast_hash_sett::insert(const fast_hash &h)
+{
+  if(is_empty_slot(h))
+  {
+    bool inserted = !has_zero;
+    has_zero = true;
+    return inserted;
+  }
+
+  std::size_t idx = find_slot(h);
+  if(!is_empty_slot(slots[idx]))
+    return false;
+
+  slots[idx] = h;
+  num_elems++;
+
+  // Keep probe sequences short
+  if(num_elems * 2 > slots.size())
+    grow();
+
+  return true;
+}
+
+void fast_hash_sett::grow()
+{
+  std::vector<fast_hash> old;
+  old.swap(slots);
+
+  slots.resize(old.size() * 2);
+  for(auto &it : slots)
+    it.hash[0] = it.hash[1] = 0;
+
+  for(auto const &it : old)
+    if(!is_empty_slot(it))
+      slots[find_slot(it)] = it;
+}
@@ -0,0 +1,76 @@
+/*******************************************************************\
+
+Module: Fast non-cryptographic 128-bit hashing
+
+\*******************************************************************/
+
+#ifndef CPROVER_FAST_HASH_H
+#define CPROVER_FAST_HASH_H
+
+#include <cstdint>
+#include <vector>
+
+/** 128-bit non-cryptographic hash, built from xxh3-style multiply-fold
+ *  rounds. Much cheaper than crypto_hash; for use where a digest only has to
+ *  tell states apart, not resist an adversary. Digests can be XOR'd together
+ *  to get an order-independent digest of a set of items. */
+class fast_hash
+{
+public:
+  uint64_t hash[2];
+
+  fast_hash();
+
+  void ingest(void const *data, unsigned int size);
+  void ingest(uint64_t val);
+  /** Mix the two lanes so that every input bit reaches every output bit */
+  void fin();
+
+  fast_hash &operator^=(const fast_hash &h2)
+  {
+    hash[0] ^= h2.hash[0];
+    hash[1] ^= h2.hash[1];
+    return *this;
+  }
+
+  bool operator==(const fast_hash &h2) const
+  {
+    return hash[0] == h2.hash[0] && hash[1] == h2.hash[1];
+  }
+
+  bool operator<(const fast_hash &h2) const
+  {
+    return hash[0] < h2.hash[0] ||
+           (hash[0] == h2.hash[0] && hash[1] < h2.hash[1]);
+  }
+};
+
+/** Set of fast_hash digests, kept in a single open-addressing table with
+ *  linear probing. The digests are already well mixed, so their low bits are
+ *  used as the slot index directly. */
+class fast_hash_sett
+{
+public:
+  fast_hash_sett();
+
+  bool contains(const fast_hash &h) const;
+  /** Returns false if h was already in the set */
+  bool insert(const fast_hash &h);
+
+  std::size_t size() const
+  {
+    return num_elems;
+  }
+
+protected:
+  /** Slots holding the all-zero digest are empty; a zero digest is stored
+   *  in has_zero instead */
+  std::vector<fast_hash> slots;
+  std::size_t num_elems;
+  bool has_zero;
+
+  std::size_t find_slot(const fast_hash &h) const;
+  void grow();
+};
+
+#endif
@@ -7,6 +7,7 @@ Author: Daniel Kroening, kroening@kroening.com
 \*******************************************************************/
 
 #include <algorithm>
+#include <unordered_set>
 #include <util/guard.h>
 #include <util/irep2_utils.h>
 #include <util/std_expr.h>
@@ -16,11 +17,15 @@ expr2tc guardt::as_expr() const
   if(is_true())
     return gen_true_expr();
 
-  if(is_single_symbol())
-    return *guard_list.begin();
+  return tail->g_expr;
+}
 
-  assert(!is_nil_expr(g_expr));
-  return g_expr;
+void guardt::push_back(const expr2tc &expr)
+{
+  // Update the chain of ands
+  expr2tc g_expr = tail ? and2tc(tail->g_expr, expr) : expr;
+  tail = std::make_shared<const nodet>(
+    nodet{expr, std::move(g_expr), tail, depth(tail) + 1});
 }
 
 void guardt::add(const expr2tc &expr)
@@ -40,21 +45,7 @@ void guardt::add(const expr2tc &expr)
     return;
   }
 
-  guard_list.push_back(expr);
-
-  // Update the chain of ands
-
-  // Easy case, there is no g_expr
-  if(is_nil_expr(g_expr))
-  {
-    g_expr = expr;
-  }
-  else
-  {
-    // Otherwise, just update the chain of ands
-    and2tc new_g_expr(g_expr, expr);
-    g_expr.swap(new_g_expr);
-  }
+  push_back(expr);
 }
 
 void guardt::guard_expr(expr2tc &dest) const
@@ -73,54 +64,58 @@ void guardt::guard_expr(expr2tc &dest) const
   dest = expr2tc(new implies2t(as_expr(), dest));
 }
 
-void guardt::build_guard_expr()
+guardt::node_ptrt guardt::common_prefix(node_ptrt a, node_ptrt b)
 {
-  // This method closely related to guardt::add and guardt::guard_expr
-  // We need to build the chain of ands, to avoid memory bloat on as_expr
-
-  // if the guard is true, or a single symbol, we don't need to build it
-  if(is_true() || is_single_symbol())
-    return;
+  while(depth(a) > depth(b))
+    a = a->parent;
+  while(depth(b) > depth(a))
+    b = b->parent;
 
-  // This method will only be used, when the guard is nil, for instance,
-  // guardt &operator -= and guardt &operator |=, all other cases should
-  // be handled by guardt::add
-  assert(is_nil_expr(g_expr));
-
-  // We can assume at least two operands
-  auto it = guard_list.begin();
+  // Only the parts that diverged are walked
+  while(a != b)
+  {
+    a = a->parent;
+    b = b->parent;
+  }
 
-  expr2tc arg1, arg2;
-  arg1 = *it++;
-  arg2 = *it++;
-  and2tc res(arg1, arg2);
-  while(it != guard_list.end())
-    res = and2tc(res, *it++);
+  return a;
+}
 
-  g_expr.swap(res);
+guardt::guard_listt
+guardt::suffix(const node_ptrt &tail, const node_ptrt &prefix)
+{
+  guard_listt res;
+  for(const nodet *n = tail.get(); n != prefix.get(); n = n->parent.get())
+    res.push_back(n->expr);
+  std::reverse(res.begin(), res.end());
+  return res;
 }
 
 void guardt::append(const guardt &guard)
 {
-  for(auto const &it : guard.guard_list)
+  // Nothing to add to, share the other guard's list
+  if(is_true())
+  {
+    tail = guard.tail;
+    return;
+  }
+
+  for(auto const &it : suffix(guard.tail, nullptr))
     add(it);
 }
 
 guardt &operator-=(guardt &g1, const guardt &g2)
 {
-  guardt::guard_listt diff;
-  std::set_difference(
-    g1.guard_list.begin(),
-    g1.guard_list.end(),
-    g2.guard_list.begin(),
-    g2.guard_list.end(),
-    std::back_inserter(diff));
-
-  // Clear g1 and build the guard's list and expr
-  g1.clear();
+  // The shared prefix is in both; of the rest, drop what g2 also has
+  guardt::node_ptrt prefix = guardt::common_prefix(g1.tail, g2.tail);
+  guardt::guard_listt s1 = guardt::suffix(g1.tail, prefix);
+  guardt::guard_listt s2 = guardt::suffix(g2.tail, prefix);
 
-  g1.guard_list.swap(diff);
-  g1.build_guard_expr();
+  std::unordered_set<expr2tc, irep2_hash> in_s2(s2.begin(), s2.end());
+  g1.clear();
+  for(auto const &it : s1)
+    if(in_s2.count(it) == 0)
+      g1.push_back(it);
 
   return g1;
 }
@@ -140,7 +135,7 @@ guardt &operator|=(guardt &g1, const guardt &g2)
   {
     // Both guards have one symbol, so check if we opposite symbols, e.g,
     // g1 == sym1 and g2 == !sym1
-    expr2tc or_expr(new or2t(*g1.guard_list.begin(), *g2.guard_list.begin()));
+    expr2tc or_expr(new or2t(g1.tail->expr, g2.tail->expr));
     simplify(or_expr);
 
     if(::is_true(or_expr))
@@ -150,7 +145,8 @@ guardt &operator|=(guardt &g1, const guardt &g2)
     }
 
     // Despite if we could simplify or not, clear and set the new guard
-    g1.clear_insert(or_expr);
+    g1.clear();
+    g1.add(or_expr);
   }
   else
   {
@@ -161,36 +157,29 @@ guardt &operator|=(guardt &g1, const guardt &g2)
     // res = g1 || g2 = (!guard3 && !guard2 && !guard1) || (guard2 && !guard1)
 
     // Simplify equation: everything that's common in both guards, will not
-    // be or'd
-
-    // Common guards
-    guardt common;
-    std::set_intersection(
-      g1.guard_list.begin(),
-      g1.guard_list.end(),
-      g2.guard_list.begin(),
-      g2.guard_list.end(),
-      std::back_inserter(common.guard_list));
-    common.build_guard_expr();
-
-    // New g1 and g2, without the common guards
-    guardt new_g1;
-    std::set_difference(
-      g1.guard_list.begin(),
-      g1.guard_list.end(),
-      common.guard_list.begin(),
-      common.guard_list.end(),
-      std::back_inserter(new_g1.guard_list));
-    new_g1.build_guard_expr();
-
-    guardt new_g2;
-    std::set_difference(
-      g2.guard_list.begin(),
-      g2.guard_list.end(),
-      common.guard_list.begin(),
-      common.guard_list.end(),
-      std::back_inserter(new_g2.guard_list));
-    new_g2.build_guard_expr();
+    // be or'd. That's the shared prefix, plus whatever both added since.
+    guardt::node_ptrt prefix = guardt::common_prefix(g1.tail, g2.tail);
+    guardt::guard_listt s1 = guardt::suffix(g1.tail, prefix);
+    guardt::guard_listt s2 = guardt::suffix(g2.tail, prefix);
+
+    std::unordered_set<expr2tc, irep2_hash> in_s2(s2.begin(), s2.end());
+    std::unordered_set<expr2tc, irep2_hash> in_common;
+    guardt::guard_listt common;
+    guardt new_g1, new_g2;
+    for(auto const &it : s1)
+    {
+      if(in_s2.count(it) != 0)
+      {
+        common.push_back(it);
+        in_common.insert(it);
+      }
+      else
+        new_g1.push_back(it);
+    }
+
+    for(auto const &it : s2)
+      if(in_common.count(it) == 0)
+        new_g2.push_back(it);
 
     // Get the and expression from both guards
     expr2tc or_expr(new or2t(new_g1.as_expr(), new_g2.as_expr()));
@@ -199,7 +188,9 @@ guardt &operator|=(guardt &g1, const guardt &g2)
     if(new_g1.is_single_symbol() && new_g2.is_single_symbol())
       simplify(or_expr);
 
-    g1.clear_append(common);
+    g1.tail = prefix;
+    for(auto const &it : common)
+      g1.push_back(it);
     g1.add(or_expr);
   }
 
@@ -208,20 +199,28 @@ guardt &operator|=(guardt &g1, const guardt &g2)
 
 void guardt::dump() const
 {
-  for(auto const &it : guard_list)
+  for(auto const &it : suffix(tail, nullptr))
     it->dump();
 }
 
 bool operator==(const guardt &g1, const guardt &g2)
 {
   // Very simple: the guard list should be identical.
-  return g1.guard_list == g2.guard_list;
+  if(guardt::depth(g1.tail) != guardt::depth(g2.tail))
+    return false;
+
+  // Stop as soon as the lists are shared
+  const guardt::nodet *a = g1.tail.get(), *b = g2.tail.get();
+  for(; a != b; a = a->parent.get(), b = b->parent.get())
+    if(a->expr != b->expr)
+      return false;
+
+  return true;
 }
 
 void guardt::swap(guardt &g)
 {
-  guard_list.swap(g.guard_list);
-  g_expr.swap(g.g_expr);
+  tail.swap(g.tail);
 }
 
 bool guardt::disjunction_may_simplify(const guardt &other_guard) const
@@ -242,21 +241,21 @@ bool guardt::disjunction_may_simplify(const guardt &other_guard) const
 
 bool guardt::is_true() const
 {
-  return guard_list.empty();
+  return !tail;
 }
 
 bool guardt::is_false() const
 {
   // Never false
-  if(guard_list.size() != 1)
+  if(depth(tail) != 1)
     return false;
 
-  return (*guard_list.begin() == gen_false_expr());
+  return (tail->expr == gen_false_expr());
 }
 
 void guardt::make_true()
 {
-  guard_list.clear();
+  tail.reset();
 }
 
 void guardt::make_false()
@@ -266,23 +265,10 @@ void guardt::make_false()
 
 bool guardt::is_single_symbol() const
 {
-  return (guard_list.size() == 1);
+  return depth(tail) == 1;
 }
 
 void guardt::clear()
 {
-  guard_list.clear();
-  g_expr.reset();
-}
-
-void guardt::clear_append(const guardt &guard)
-{
-  clear();
-  append(guard);
-}
-
-void guardt::clear_insert(const expr2tc &expr)
-{
-  clear();
-  add(expr);
+  tail.reset();
 }
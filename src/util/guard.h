@@ -10,6 +10,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #define CPROVER_GUARD_H
 
 #include <iostream>
+#include <memory>
 #include <util/expr.h>
 #include <util/irep2.h>
 #include <util/migrate.h>
@@ -47,15 +48,38 @@ public:
   void dump() const;
 
 protected:
-  guard_listt guard_list;
-  expr2tc g_expr;
+  /** One conjunct of a guard, linked to the conjuncts before it. Nodes never
+   *  change once built, so guards share them: copying a guard is O(1), and
+   *  guards copied from one another share their common prefix, which is found
+   *  by comparing pointers. */
+  struct nodet
+  {
+    expr2tc expr;
+    /** Chain of ands of the conjuncts up to and including this one */
+    expr2tc g_expr;
+    std::shared_ptr<const nodet> parent;
+    /** Number of conjuncts up to and including this one */
+    unsigned int depth;
+  };
+  typedef std::shared_ptr<const nodet> node_ptrt;
+
+  /** Last conjunct; nullptr if the guard is true */
+  node_ptrt tail;
 
   bool is_single_symbol() const;
   void clear();
-  void clear_append(const guardt &guard);
-  void clear_insert(const expr2tc &expr);
+  void push_back(const expr2tc &expr);
+
+  static unsigned int depth(const node_ptrt &node)
+  {
+    return node ? node->depth : 0;
+  }
 
-  void build_guard_expr();
+  /** Last node the two lists have in common */
+  static node_ptrt common_prefix(node_ptrt a, node_ptrt b);
+  /** Conjuncts after prefix up to tail, in order */
+  static guard_listt
+  suffix(const node_ptrt &tail, const node_ptrt &prefix);
 };
 
 #endif
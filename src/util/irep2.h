@@ -1474,6 +1474,9 @@ inline bool operator>(const type2tc &a, const type2tc &b)
 
 inline bool operator==(const expr2tc &a, const expr2tc &b)
 {
+  // Also covers both being nil. Shared and hash-consed nodes stop here.
+  if(a.get() == b.get())
+    return true;
   if(is_nil_expr(a) && is_nil_expr(b))
     return true;
   if(is_nil_expr(a) || is_nil_expr(b))
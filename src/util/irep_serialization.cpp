@@ -8,6 +8,7 @@ Date: May 2007
 
 \*******************************************************************/
 
+#include <iostream>
 #include <sstream>
 #include <util/irep_serialization.h>
 
@@ -168,8 +169,11 @@ void irep_serializationt::write_string_ref(std::ostream &out, const dstring &s)
   if(id >= ireps_container.string_map.size())
     ireps_container.string_map.resize(id + 1, false);
 
-  if(ireps_container.string_map[id])
+  if(ireps_container.string_map[id] || ireps_container.strings_in_table)
+  {
+    ireps_container.string_map[id] = true;
     write_long(out, id);
+  }
   else
   {
     ireps_container.string_map[id] = true;
@@ -190,6 +194,12 @@ irep_idt irep_serializationt::read_string_ref(std::istream &in)
     return ireps_container.string_rev_map[id].second;
   }
 
+  if(ireps_container.strings_in_table)
+  {
+    std::cerr << "string " << id << " not in string table" << std::endl;
+    throw 0;
+  }
+
   dstring s = read_string(in);
   ireps_container.string_rev_map[id] = std::pair<bool, dstring>(true, s);
   return ireps_container.string_rev_map[id].second;
@@ -72,13 +72,26 @@ public:
     typedef std::vector<std::pair<bool, dstring>> string_rev_mapt;
     string_rev_mapt string_rev_map;
 
+    /** Strings are kept in a table of their own rather than written out
+     *  where they're first used: string refs are only ever ids. Writers
+     *  record the ids used in string_map; readers must have filled in
+     *  string_rev_map beforehand. */
+    bool strings_in_table = false;
+
     void clear()
     {
-      ireps_on_write.clear();
-      ireps_on_read.clear();
+      clear_ireps();
       string_map.clear();
       string_rev_map.clear();
     }
+
+    /** Forget the ireps seen so far but keep the strings, so that what's
+     *  written next doesn't refer back to earlier ireps */
+    void clear_ireps()
+    {
+      ireps_on_write.clear();
+      ireps_on_read.clear();
+    }
   };
 
   irep_serializationt(ireps_containert &ic) : ireps_container(ic)
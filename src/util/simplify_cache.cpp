@@ -0,0 +1,106 @@
+/*******************************************************************\
+
+Module: Memo of expression simplification
+
+\*******************************************************************/
+
+#include <unordered_map>
+#include <util/simplify_cache.h>
+
+std::size_t simplify_cachet::capacity = 0;
+std::size_t simplify_cachet::hits = 0;
+std::size_t simplify_cachet::misses = 0;
+std::size_t simplify_cachet::evicted = 0;
+
+namespace
+{
+/* Lookups key on the expression being simplified, which needn't be owned by
+ * an expr2tc; entries own a copy of its top node. */
+struct cache_keyt
+{
+  const expr2t *expr;
+  expr2tc owner;
+};
+
+struct cache_key_hash
+{
+  size_t operator()(const cache_keyt &k) const
+  {
+    return k.expr->crc();
+  }
+};
+
+struct cache_key_eq
+{
+  bool operator()(const cache_keyt &a, const cache_keyt &b) const
+  {
+    return a.expr == b.expr || *a.expr == *b.expr;
+  }
+};
+
+typedef std::unordered_map<cache_keyt, expr2tc, cache_key_hash, cache_key_eq>
+  generationt;
+
+generationt current, previous;
+} // namespace
+
+void simplify_cachet::set_capacity(std::size_t entries)
+{
+  capacity = entries;
+  clear();
+}
+
+bool simplify_cachet::lookup(const expr2t &expr, expr2tc &result)
+{
+  cache_keyt key = {&expr, expr2tc()};
+
+  auto it = current.find(key);
+  if(it != current.end())
+  {
+    ++hits;
+    result = it->second;
+    return true;
+  }
+
+  it = previous.find(key);
+  if(it == previous.end())
+  {
+    ++misses;
+    return false;
+  }
+
+  // Still in use, keep it
+  ++hits;
+  result = it->second;
+  insert(expr, result);
+  return true;
+}
+
+void simplify_cachet::insert(const expr2t &expr, const expr2tc &result)
+{
+  if(capacity == 0)
+    return;
+
+  if(current.size() >= capacity)
+  {
+    evicted += previous.size();
+    previous.swap(current);
+    current.clear();
+  }
+
+  expr2tc owner = expr.clone();
+  current.emplace(cache_keyt{owner.get(), owner}, result);
+}
+
+void simplify_cachet::clear()
+{
+  current.clear();
+  previous.clear();
+}
+
+void simplify_cachet::print_stats(std::ostream &out)
+{
+  out << "Simplification cache: " << hits << " hits, " << misses
+      << " misses, " << evicted << " evicted, "
+      << current.size() + previous.size() << " entries" << std::endl;
+}
@@ -0,0 +1,46 @@
+/*******************************************************************\
+
+Module: Memo of expression simplification
+
+\*******************************************************************/
+
+#ifndef CPROVER_SIMPLIFY_CACHE_H
+#define CPROVER_SIMPLIFY_CACHE_H
+
+#include <iostream>
+#include <util/irep2.h>
+
+/** Results of expr2t::simplify, keyed on the simplified expression's
+ *  structure (crc() and operator==), nil results included.
+ *
+ *  Entries are kept in two generations of at most `capacity` entries each.
+ *  When the current generation is full, the previous one is dropped and the
+ *  current one takes its place; an entry found in the previous generation
+ *  moves back into the current one. So the cache holds at most twice its
+ *  capacity, and what is still being used survives. */
+class simplify_cachet
+{
+public:
+  /** Set the number of entries per generation; 0 disables the cache */
+  static void set_capacity(std::size_t entries);
+
+  static bool enabled()
+  {
+    return capacity != 0;
+  }
+
+  /** Find the result of simplifying expr, if it's known */
+  static bool lookup(const expr2t &expr, expr2tc &result);
+  static void insert(const expr2t &expr, const expr2tc &result);
+
+  static void clear();
+  static void print_stats(std::ostream &out);
+
+protected:
+  static std::size_t capacity;
+  static std::size_t hits;
+  static std::size_t misses;
+  static std::size_t evicted;
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include <util/expr_util.h>
 #include <util/irep2.h>
 #include <util/irep2_utils.h>
+#include <util/simplify_cache.h>
 #include <util/type_byte_size.h>
 
 expr2tc expr2t::do_simplify() const
@@ -13,23 +14,44 @@ expr2tc expr2t::do_simplify() const
   return expr2tc();
 }
 
+static expr2tc simplify_uncached(const expr2t &expr);
+
 expr2tc expr2t::simplify() const
 {
+  // Leaves are as cheap to simplify as to look up
+  bool memo = simplify_cachet::enabled() && get_num_sub_exprs() != 0;
+
+  expr2tc res;
+  if(memo && simplify_cachet::lookup(*this, res))
+    return res;
+
+  res = simplify_uncached(*this);
+
+  if(memo)
+    simplify_cachet::insert(*this, res);
+
+  return res;
+}
+
+static expr2tc simplify_uncached(const expr2t &expr)
+{
+  const expr2t::expr_ids expr_id = expr.expr_id;
+
   try
   {
     // Corner case! Don't even try to simplify address of's operands, might end up
     // taking the address of some /completely/ arbitary pice of data, by
     // simplifiying an index to its data, discarding the symbol.
-    if(__builtin_expect((expr_id == address_of_id), 0)) // unlikely
+    if(__builtin_expect((expr_id == expr2t::address_of_id), 0)) // unlikely
       return expr2tc();
 
     // And overflows too. We don't wish an add to distribute itself, for example,
     // when we're trying to work out whether or not it's going to overflow.
-    if(__builtin_expect((expr_id == overflow_id), 0))
+    if(__builtin_expect((expr_id == expr2t::overflow_id), 0))
       return expr2tc();
 
     // Try initial simplification
-    expr2tc res = do_simplify();
+    expr2tc res = expr.do_simplify();
     if(!is_nil_expr(res))
     {
       // Woot, we simplified some of this. It may have _additional_ fields that
@@ -48,9 +70,9 @@ expr2tc expr2t::simplify() const
     bool changed = false;
     std::list<expr2tc> newoperands;
 
-    for(unsigned int idx = 0; idx < get_num_sub_exprs(); idx++)
+    for(unsigned int idx = 0; idx < expr.get_num_sub_exprs(); idx++)
     {
-      const expr2tc *e = get_sub_expr(idx);
+      const expr2tc *e = expr.get_sub_expr(idx);
       expr2tc tmp;
 
       if(!is_nil_expr(*e))
@@ -68,10 +90,10 @@ expr2tc expr2t::simplify() const
       // holding something back until it's certain all its operands are
       // simplified. It's responsible for simplifying further if it's made that
       // call though.
-      return do_simplify();
+      return expr.do_simplify();
 
     // An operand has been changed; clone ourselves and update.
-    expr2tc new_us = clone();
+    expr2tc new_us = expr.clone();
     std::list<expr2tc>::iterator it2 = newoperands.begin();
     new_us->Foreach_operand([&it2](expr2tc &e) {
       if((*it2) == nullptr)